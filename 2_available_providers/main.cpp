@@ -2,11 +2,95 @@
 #include <vector>   // For std::vector
 #include <string>   // For std::string
 #include <cstdlib>  // For EXIT_SUCCESS/EXIT_FAILURE
+#include <cstring>  // For std::strcmp
+#include <chrono>   // For timing each provider
+#include <algorithm> // For std::find, std::sort
 
 // ONNX Runtime C++ API header file
 #include <onnxruntime_cxx_api.h>
 
-int main() {
+#include "provider_config.h"
+#include "synthetic_inputs.h"
+
+// Result of timing one execution provider on the model.
+struct ProviderTiming {
+    std::string name;
+    bool ok = false;
+    std::string error;
+    double session_ms = 0.0; // Session creation time.
+    double mean_us = 0.0;    // Mean Run latency after warm-up.
+    double p50_us = 0.0;
+};
+
+// Creates a session with the given provider and times Run on random inputs whose
+// first dynamic dimension is batch_size (other dynamic dimensions become 1).
+ProviderTiming time_provider(Ort::Env& env, const char* model_path, const std::string& provider,
+                             long batch_size, int runs) {
+    ProviderTiming timing;
+    timing.name = provider;
+    try {
+        Ort::SessionOptions session_options;
+        append_provider(session_options, provider);
+
+        auto create_begin = std::chrono::steady_clock::now();
+        Ort::Session session(env, model_path, session_options);
+        timing.session_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - create_begin).count();
+
+        // Random inputs of every input's own type; the first dynamic dimension is the batch.
+        SyntheticInputs inputs(session, DimOverrides::batch(batch_size));
+        auto run_once = [&] { inputs.run(session); };
+        for (int i = 0; i < 10; ++i) {
+            run_once(); // Warm-up: first runs include allocation planning.
+        }
+        std::vector<double> latencies_us;
+        for (int i = 0; i < runs; ++i) {
+            auto run_begin = std::chrono::steady_clock::now();
+            run_once();
+            latencies_us.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - run_begin).count());
+        }
+        std::sort(latencies_us.begin(), latencies_us.end());
+        double total_us = 0.0;
+        for (double latency : latencies_us) {
+            total_us += latency;
+        }
+        timing.mean_us = total_us / runs;
+        timing.p50_us = latencies_us[latencies_us.size() / 2];
+        timing.ok = true;
+    } catch (const std::exception& ex) {
+        timing.error = ex.what();
+    }
+    return timing;
+}
+
+int main(int argc, char* argv[]) {
+    // Optional: benchmark the providers on a model and save the fastest choice.
+    const char* model_path = nullptr;
+    long batch_size = 1;
+    int runs = 200;
+    std::string save_path;
+    try {
+        for (int i = 1; i < argc; ++i) {
+            if (std::strcmp(argv[i], "--batch") == 0 && i + 1 < argc) {
+                batch_size = std::stol(argv[++i]);
+            } else if (std::strcmp(argv[i], "--runs") == 0 && i + 1 < argc) {
+                runs = std::stoi(argv[++i]);
+            } else if (std::strcmp(argv[i], "--save") == 0 && i + 1 < argc) {
+                save_path = argv[++i];
+            } else if (argv[i][0] != '-' && model_path == nullptr) {
+                model_path = argv[i];
+            } else {
+                throw std::invalid_argument(argv[i]);
+            }
+        }
+        if (batch_size <= 0 || runs <= 0 || (!save_path.empty() && model_path == nullptr)) {
+            throw std::invalid_argument("invalid arguments");
+        }
+    } catch (const std::exception&) {
+        std::cerr << "Usage: " << argv[0] << " [model_path [--batch N] [--runs N] [--save <config_file>]]" << std::endl;
+        std::cerr << "Example: " << argv[0] << " data/linear/linear.onnx --batch 256 --save linear.ep" << std::endl;
+        return EXIT_FAILURE;
+    }
+
     std::cout << "--- ONNX Runtime Execution Provider (EP) Information ---" << std::endl;
 
     // --- 1. Initialize ONNX Runtime Environment ---
@@ -30,6 +114,51 @@ int main() {
             }
         }
 
+        // --- 3. Optionally Benchmark the CPU-capable Providers on a Model ---
+        if (model_path != nullptr) {
+            std::cout << "\n--- Provider Benchmark ---" << std::endl;
+            std::cout << "Model: " << model_path << ", batch size: " << batch_size << ", runs: " << runs << std::endl;
+
+            std::vector<ProviderTiming> timings;
+            for (const auto& candidate : cpu_provider_candidates()) {
+                bool available = std::find(available_providers.begin(), available_providers.end(),
+                                           candidate.ort_name) != available_providers.end();
+                if (!available) {
+                    std::cout << "- " << candidate.name << ": not in this build, skipped" << std::endl;
+                    continue;
+                }
+                ProviderTiming timing = time_provider(env, model_path, candidate.name, batch_size, runs);
+                if (timing.ok) {
+                    std::cout << "- " << timing.name << ": session " << timing.session_ms << " ms, Run mean "
+                              << timing.mean_us << " us, p50 " << timing.p50_us << " us" << std::endl;
+                    timings.push_back(timing);
+                } else {
+                    std::cout << "- " << timing.name << ": failed (" << timing.error << ")" << std::endl;
+                }
+            }
+
+            if (timings.empty()) {
+                std::cerr << "Error: no provider could run the model." << std::endl;
+                return EXIT_FAILURE;
+            }
+            const ProviderTiming* fastest = &timings[0];
+            for (const auto& timing : timings) {
+                if (timing.mean_us < fastest->mean_us) {
+                    fastest = &timing;
+                }
+            }
+            std::cout << "\nRecommended provider: " << fastest->name << std::endl;
+
+            if (!save_path.empty()) {
+                ProviderConfig config;
+                config.model = model_path;
+                config.batch_size = batch_size;
+                config.provider = fastest->name;
+                save_provider_config(save_path, config);
+                std::cout << "Saved provider choice to: " << save_path << std::endl;
+            }
+        }
+
     } catch (const Ort::Exception& ex) {
         // Catch ONNX Runtime-specific exceptions
         std::cerr << "ONNX Runtime Error: " << ex.what() << std::endl;
@@ -3,60 +3,110 @@
 #include <string>   // For std::string to handle tensor names
 #include <numeric>  // For std::accumulate (useful for calculating total elements)
 #include <cstdlib>  // For EXIT_FAILURE/EXIT_SUCCESS
-#include <algorithm> // For std::all_of
+#include <algorithm> // For std::sort
+#include <cstring>  // For std::strcmp
+#include <chrono>   // For timing benchmark runs
+
+#include <sys/resource.h> // For getrusage (peak RSS)
 
 // ONNX Runtime C++ API header file
 #include <onnxruntime_cxx_api.h>
 
-// Helper function to convert ONNXTensorElementDataType to a readable string
-// This function helps in displaying the data type of the tensor.
-std::string get_tensor_data_type_string(ONNXTensorElementDataType type) {
-    switch (type) {
-        case ONNX_TENSOR_ELEMENT_DATA_TYPE_UNDEFINED: return "undefined";
-        case ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT: return "float";
-        case ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT8: return "uint8";
-        case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT8: return "int8";
-        case ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT16: return "uint16";
-        case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT16: return "int16";
-        case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT32: return "int32";
-        case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT64: return "int64";
-        case ONNX_TENSOR_ELEMENT_DATA_TYPE_STRING: return "string";
-        case ONNX_TENSOR_ELEMENT_DATA_TYPE_BOOL: return "bool";
-        case ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT16: return "float16";
-        case ONNX_TENSOR_ELEMENT_DATA_TYPE_DOUBLE: return "double";
-        case ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT32: return "uint32";
-        case ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT64: return "uint64";
-        case ONNX_TENSOR_ELEMENT_DATA_TYPE_COMPLEX64: return "complex64";
-        case ONNX_TENSOR_ELEMENT_DATA_TYPE_COMPLEX128: return "complex128";
-        case ONNX_TENSOR_ELEMENT_DATA_TYPE_BFLOAT16: return "bfloat16";
-        default: return "unknown";
+#include "inference_runner.h"
+#include "profile_summary.h"
+#include "synthetic_inputs.h"
+#include "tensor_info.h"
+
+// Prints one input's or output's name, data type, shape and element count.
+void print_tensor_metadata(const TensorMetadata& metadata) {
+    std::cout << "    Name: " << metadata.name << std::endl;
+    std::cout << "    Data Type: " << get_tensor_data_type_string(metadata.type) << std::endl;
+    // -1 indicates a dynamic dimension (e.g., batch size), printed as "dynamic"
+    std::cout << "    Shape: " << shape_to_string(metadata.shape) << std::endl;
+
+    // Get total number of elements (if shape is static)
+    // Using the shared is_shape_static helper function for compatibility.
+    if (is_shape_static(metadata.shape)) {
+        size_t total_elements = 1;
+        for (int64_t dim : metadata.shape) {
+            total_elements *= static_cast<size_t>(dim);
+        }
+        std::cout << "    Total Elements (if static): " << total_elements << std::endl;
+    } else {
+        std::cout << "    Total Elements: Varies (dynamic shape)" << std::endl;
     }
 }
 
-// Custom helper function to check if a shape is static (contains no -1)
-// This replaces the HasStaticShape() method for broader compatibility.
-bool is_shape_static(const std::vector<int64_t>& shape) {
-    for (int64_t dim : shape) {
-        if (dim == -1) {
-            return false;
+// Prints the name, type and resolved shape of every synthetic input.
+void print_synthetic_inputs(const SyntheticInputs& inputs) {
+    for (size_t i = 0; i < inputs.names().size(); ++i) {
+        std::cout << "  Synthetic input '" << inputs.names()[i] << "': "
+                  << get_tensor_data_type_string(inputs.types()[i]) << " [";
+        const auto& shape = inputs.shapes()[i];
+        for (size_t j = 0; j < shape.size(); ++j) {
+            std::cout << shape[j] << (j + 1 < shape.size() ? ", " : "");
         }
+        std::cout << "]" << std::endl;
     }
-    return true;
+    std::cout << "  Synthetic input bytes: " << inputs.arena_bytes() << " bytes" << std::endl;
+}
+
+void print_usage(const char* program) {
+    std::cerr << "Usage: " << program << " <model_path> [--profile | --bench N] [--runs N] [--dim [name=]value]..." << std::endl;
+    std::cerr << "Example: " << program << " model/linear.onnx" << std::endl;
+    std::cerr << "Example: " << program << " linear.onnx" << std::endl;
+    std::cerr << "Example: " << program << " linear.onnx --profile --runs 100 --dim batch_size=64" << std::endl;
+    std::cerr << "Example: " << program << " linear.onnx --bench 1000 --dim batch_size=256" << std::endl;
+    std::cerr << "  --profile        Run the model on synthetic inputs with profiling enabled" << std::endl;
+    std::cerr << "                   and summarize time per operator type and node." << std::endl;
+    std::cerr << "  --runs N         Number of profiled runs (default 10)." << std::endl;
+    std::cerr << "  --bench N        Run the model N times on synthetic inputs and report throughput." << std::endl;
+    std::cerr << "  --dim name=value Value for the dynamic dimension called 'name'." << std::endl;
+    std::cerr << "  --dim value      Value for all other dynamic dimensions (default 1)." << std::endl;
 }
 
 int main(int argc, char* argv[]) {
-    // Check if the correct number of command-line arguments is provided.
-    // argc should be 2: 1 for the program name itself, 1 for the model path.
-    if (argc != 2) {
-        std::cerr << "Usage: " << argv[0] << " <model_path>" << std::endl;
-        std::cerr << "Example: " << argv[0] << " model/linear.onnx" << std::endl;
-        std::cerr << "Example: " << argv[0] << " linear.onnx" << std::endl;
+    // The model path is the first argument provided by the user; options may follow.
+    if (argc < 2 || argv[1][0] == '-') {
+        print_usage(argv[0]);
         return EXIT_FAILURE; // Indicate an error due to incorrect usage
     }
-
-    // The model path is the first argument provided by the user.
     const char* model_path = argv[1];
 
+    bool profile = false;
+    int num_runs = 10;
+    int bench_runs = 0;
+    DimOverrides dim_overrides;
+    try {
+        for (int i = 2; i < argc; ++i) {
+            if (std::strcmp(argv[i], "--profile") == 0) {
+                profile = true;
+            } else if (std::strcmp(argv[i], "--runs") == 0 && i + 1 < argc) {
+                num_runs = std::stoi(argv[++i]);
+            } else if (std::strcmp(argv[i], "--bench") == 0 && i + 1 < argc) {
+                bench_runs = std::stoi(argv[++i]);
+                if (bench_runs <= 0) {
+                    throw std::invalid_argument("--bench must be positive");
+                }
+            } else if (std::strcmp(argv[i], "--dim") == 0 && i + 1 < argc) {
+                dim_overrides.parse(argv[++i]);
+            } else {
+                throw std::invalid_argument(argv[i]);
+            }
+        }
+        if (num_runs <= 0) {
+            throw std::invalid_argument("--runs must be positive");
+        }
+        if (profile && bench_runs > 0) {
+            // Profiling adds overhead to every run, which would distort the benchmark.
+            throw std::invalid_argument("--profile and --bench cannot be combined");
+        }
+    } catch (const std::exception& ex) {
+        std::cerr << "Error: " << ex.what() << std::endl;
+        print_usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
     std::cout << "--- ONNX Runtime Model Information Example ---" << std::endl;
     std::cout << "Attempting to load model from: " << model_path << std::endl;
 
@@ -67,8 +117,12 @@ int main(int argc, char* argv[]) {
     std::cout << "ONNX Runtime environment initialized." << std::endl;
 
     // --- 2. Define Session Options ---
-    // Create session options. Default options are used here.
+    // Create session options. Default options are used unless profiling is requested,
+    // in which case ORT writes a JSON trace whose file name starts with this prefix.
     Ort::SessionOptions session_options;
+    if (profile) {
+        session_options.EnableProfiling("onnx_model_info_profile");
+    }
 
     // --- 3. Load Model and Create Session ---
     // Create an ONNX Runtime session by loading the model.
@@ -77,109 +131,81 @@ int main(int argc, char* argv[]) {
         Ort::Session session(env, model_path, session_options);
         std::cout << "Model loaded successfully." << std::endl;
 
-        // Get a memory allocator for obtaining string names.
-        Ort::AllocatorWithDefaultOptions allocator;
+        // The runner reads every input's and output's name, type and shape once.
+        InferenceRunner runner(session);
 
         // --- 4. Get Input Tensor Information ---
         std::cout << "\n--- Input Tensor Information ---" << std::endl;
 
         // Get the number of input nodes in the model.
-        size_t num_input_nodes = session.GetInputCount();
-        std::cout << "Number of input nodes: " << num_input_nodes << std::endl;
-
-        // Vectors to store smart pointers for names and their C-style string pointers.
-        std::vector<Ort::AllocatedStringPtr> input_name_ptrs;
-        // std::vector<const char*> input_names_c_str; // No longer needed directly for this logic
-
-        for (size_t i = 0; i < num_input_nodes; ++i) {
+        std::cout << "Number of input nodes: " << runner.input_count() << std::endl;
+        for (size_t i = 0; i < runner.input_count(); ++i) {
             std::cout << "  Input " << i << ":" << std::endl;
-
-            // Get input name
-            input_name_ptrs.push_back(session.GetInputNameAllocated(i, allocator));
-            std::cout << "    Name: " << input_name_ptrs.back().get() << std::endl;
-
-            // Get input type information
-            Ort::TypeInfo input_type_info = session.GetInputTypeInfo(i);
-            // Cast to TensorTypeAndShapeInfo to get tensor-specific details.
-            auto input_tensor_info = input_type_info.GetTensorTypeAndShapeInfo();
-
-            // Get data type
-            ONNXTensorElementDataType input_data_type = input_tensor_info.GetElementType();
-            std::cout << "    Data Type: " << get_tensor_data_type_string(input_data_type) << std::endl;
-
-            // Get shape
-            std::vector<int64_t> input_node_dims = input_tensor_info.GetShape();
-            std::cout << "    Shape: [";
-            for (size_t j = 0; j < input_node_dims.size(); ++j) {
-                // -1 indicates a dynamic dimension (e.g., batch size)
-                if (input_node_dims[j] == -1) {
-                    std::cout << "dynamic";
-                } else {
-                    std::cout << input_node_dims[j];
-                }
-                if (j < input_node_dims.size() - 1) {
-                    std::cout << ", ";
-                }
-            }
-            std::cout << "]" << std::endl;
-
-            // Get total number of elements (if shape is static)
-            // Using our custom is_shape_static helper function for compatibility.
-            if (is_shape_static(input_node_dims)) {
-                std::cout << "    Total Elements (if static): " << input_tensor_info.GetElementCount() << std::endl;
-            } else {
-                std::cout << "    Total Elements: Varies (dynamic shape)" << std::endl;
-            }
+            print_tensor_metadata(runner.inputs()[i]);
         }
 
         // --- 5. Get Output Tensor Information ---
         std::cout << "\n--- Output Tensor Information ---" << std::endl;
 
         // Get the number of output nodes in the model.
-        size_t num_output_nodes = session.GetOutputCount();
-        std::cout << "Number of output nodes: " << num_output_nodes << std::endl;
+        std::cout << "Number of output nodes: " << runner.output_count() << std::endl;
+        for (size_t i = 0; i < runner.output_count(); ++i) {
+            std::cout << "  Output " << i << ":" << std::endl;
+            print_tensor_metadata(runner.outputs()[i]);
+        }
 
-        // Vectors to store smart pointers for names and their C-style string pointers.
-        std::vector<Ort::AllocatedStringPtr> output_name_ptrs;
-        // std::vector<const char*> output_names_c_str; // No longer needed directly for this logic
+        // --- 6. Optionally Profile the Model on Synthetic Inputs ---
+        if (profile) {
+            std::cout << "\n--- Profiling ---" << std::endl;
+            SyntheticInputs inputs(session, dim_overrides);
+            print_synthetic_inputs(inputs);
 
-        for (size_t i = 0; i < num_output_nodes; ++i) {
-            std::cout << "  Output " << i << ":" << std::endl;
+            std::cout << "Running " << num_runs << " profiled runs..." << std::endl;
+            for (int run = 0; run < num_runs; ++run) {
+                inputs.run(session);
+            }
 
-            // Get output name
-            output_name_ptrs.push_back(session.GetOutputNameAllocated(i, allocator));
-            std::cout << "    Name: " << output_name_ptrs.back().get() << std::endl;
-
-            // Get output type information
-            Ort::TypeInfo output_type_info = session.GetOutputTypeInfo(i);
-            auto output_tensor_info = output_type_info.GetTensorTypeAndShapeInfo();
-
-            // Get data type
-            ONNXTensorElementDataType output_data_type = output_tensor_info.GetElementType();
-            std::cout << "    Data Type: " << get_tensor_data_type_string(output_data_type) << std::endl;
-
-            // Get shape
-            std::vector<int64_t> output_node_dims = output_tensor_info.GetShape();
-            std::cout << "    Shape: [";
-            for (size_t j = 0; j < output_node_dims.size(); ++j) {
-                if (output_node_dims[j] == -1) {
-                    std::cout << "dynamic";
-                } else {
-                    std::cout << output_node_dims[j];
-                }
-                if (j < output_node_dims.size() - 1) {
-                    std::cout << ", ";
-                }
+            // Ending profiling flushes the trace and returns its file name.
+            Ort::AllocatorWithDefaultOptions allocator;
+            Ort::AllocatedStringPtr trace_path = session.EndProfilingAllocated(allocator);
+            std::cout << "Profile trace written to: " << trace_path.get() << std::endl;
+
+            print_profile_summary(summarize_profile(trace_path.get()));
+
+            rusage usage;
+            getrusage(RUSAGE_SELF, &usage);
+            std::cout << "\nPeak RSS (process): " << usage.ru_maxrss << " KB" << std::endl;
+        }
+
+        // --- 7. Optionally Benchmark the Model on Synthetic Inputs ---
+        if (bench_runs > 0) {
+            std::cout << "\n--- Benchmark ---" << std::endl;
+            SyntheticInputs inputs(session, dim_overrides);
+            print_synthetic_inputs(inputs);
+
+            // A few untimed runs let ORT finish allocation planning first.
+            for (int run = 0; run < 5; ++run) {
+                inputs.run(session);
             }
-            std::cout << "]" << std::endl;
 
-            // Get total number of elements (if shape is static)
-            // Using our custom is_shape_static helper function for compatibility.
-            if (is_shape_static(output_node_dims)) {
-                std::cout << "    Total Elements (if static): " << output_tensor_info.GetElementCount() << std::endl;
-            } else {
-                std::cout << "    Total Elements: Varies (dynamic shape)" << std::endl;
+            std::vector<double> latencies_us;
+            latencies_us.reserve(bench_runs);
+            auto bench_begin = std::chrono::steady_clock::now();
+            for (int run = 0; run < bench_runs; ++run) {
+                auto run_begin = std::chrono::steady_clock::now();
+                inputs.run(session);
+                latencies_us.push_back(std::chrono::duration<double, std::micro>(
+                    std::chrono::steady_clock::now() - run_begin).count());
             }
+            double bench_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - bench_begin).count();
+
+            std::sort(latencies_us.begin(), latencies_us.end());
+            double total_us = std::accumulate(latencies_us.begin(), latencies_us.end(), 0.0);
+            std::cout << "Runs: " << bench_runs << std::endl;
+            std::cout << "Throughput: " << bench_runs / bench_seconds << " runs/s" << std::endl;
+            std::cout << "Latency mean: " << total_us / bench_runs << " us" << std::endl;
+            std::cout << "Latency p50: " << latencies_us[latencies_us.size() / 2] << " us" << std::endl;
+            std::cout << "Latency p99: " << latencies_us[(latencies_us.size() - 1) * 99 / 100] << " us" << std::endl;
         }
 
     } catch (const Ort::Exception& ex) {
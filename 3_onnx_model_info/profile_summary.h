@@ -0,0 +1,212 @@
+#pragma once
+
+#include <algorithm> // For std::sort
+#include <cstdlib>   // For std::strtod
+#include <fstream>   // For reading the trace file
+#include <iomanip>   // For std::setw, std::setprecision
+#include <iostream>  // For printing the summary
+#include <map>       // For aggregating by operator type and node
+#include <sstream>   // For reading the whole trace
+#include <stdexcept> // For std::runtime_error
+#include <string>    // For std::string
+#include <vector>    // For sorting the aggregated rows
+
+// Summarizes the JSON trace written by SessionOptions::EnableProfiling.
+//
+// The trace is a JSON array of Chrome-trace events. For every Run, ORT emits a
+// "Session" event named "model_run" and, per executed node, a "Node" event
+// named "<node>_kernel_time" whose args carry the operator type and the
+// parameter/activation/output sizes in bytes. Only these fields are needed,
+// so the events are scanned with a small purpose-built reader instead of a
+// full JSON parser.
+
+struct ProfileRow {
+    std::string name;
+    std::string op_type;
+    double total_us = 0.0;
+    size_t calls = 0;
+    double output_bytes = 0.0;     // Sum over calls of bytes written by the node.
+    double activation_bytes = 0.0; // Largest activation (input) size seen for the node.
+    double parameter_bytes = 0.0;  // Weights used by the node (counted once per node).
+};
+
+struct ProfileSummary {
+    double model_run_us = 0.0; // Total "model_run" time over all runs.
+    size_t runs = 0;
+    std::map<std::string, ProfileRow> by_op_type;
+    std::map<std::string, ProfileRow> by_node;
+};
+
+namespace profile_detail {
+
+// Returns the raw value of "key" in a flat or nested JSON object text:
+// a string without quotes, or a number/literal as written. Empty if absent.
+inline std::string find_field(const std::string& object, const std::string& key) {
+    std::string quoted_key = "\"" + key + "\"";
+    size_t pos = object.find(quoted_key);
+    if (pos == std::string::npos) {
+        return std::string();
+    }
+    pos = object.find(':', pos + quoted_key.size());
+    if (pos == std::string::npos) {
+        return std::string();
+    }
+    pos = object.find_first_not_of(" \t\r\n", pos + 1);
+    if (pos == std::string::npos) {
+        return std::string();
+    }
+    if (object[pos] == '"') {
+        size_t end = object.find('"', pos + 1);
+        return end == std::string::npos ? std::string() : object.substr(pos + 1, end - pos - 1);
+    }
+    size_t end = object.find_first_of(",}] \t\r\n", pos);
+    return object.substr(pos, end == std::string::npos ? std::string::npos : end - pos);
+}
+
+inline double find_number(const std::string& object, const std::string& key) {
+    std::string value = find_field(object, key);
+    return value.empty() ? 0.0 : std::strtod(value.c_str(), nullptr);
+}
+
+// Splits the top-level JSON array into the text of its element objects.
+inline std::vector<std::string> split_events(const std::string& trace) {
+    std::vector<std::string> events;
+    int depth = 0;
+    bool in_string = false;
+    size_t start = 0;
+    for (size_t i = 0; i < trace.size(); ++i) {
+        char c = trace[i];
+        if (in_string) {
+            if (c == '\\') {
+                ++i;
+            } else if (c == '"') {
+                in_string = false;
+            }
+            continue;
+        }
+        if (c == '"') {
+            in_string = true;
+        } else if (c == '{') {
+            if (depth++ == 0) {
+                start = i;
+            }
+        } else if (c == '}') {
+            if (--depth == 0) {
+                events.push_back(trace.substr(start, i - start + 1));
+            }
+        }
+    }
+    return events;
+}
+
+inline void add_sample(ProfileRow& row, const std::string& name, const std::string& op_type, double dur,
+                       double output_bytes, double activation_bytes, double parameter_bytes) {
+    row.name = name;
+    row.op_type = op_type;
+    row.total_us += dur;
+    row.calls += 1;
+    row.output_bytes += output_bytes;
+    row.activation_bytes = std::max(row.activation_bytes, activation_bytes);
+    row.parameter_bytes = std::max(row.parameter_bytes, parameter_bytes);
+}
+
+} // namespace profile_detail
+
+inline ProfileSummary summarize_profile(const std::string& trace_path) {
+    std::ifstream file(trace_path);
+    if (!file) {
+        throw std::runtime_error("cannot open profile trace: " + trace_path);
+    }
+    std::stringstream contents;
+    contents << file.rdbuf();
+
+    ProfileSummary summary;
+    const std::string kernel_suffix = "_kernel_time";
+    for (const std::string& event : profile_detail::split_events(contents.str())) {
+        std::string category = profile_detail::find_field(event, "cat");
+        std::string name = profile_detail::find_field(event, "name");
+        double dur = profile_detail::find_number(event, "dur");
+
+        if (category == "Session" && name == "model_run") {
+            summary.model_run_us += dur;
+            summary.runs += 1;
+        } else if (category == "Node" && name.size() > kernel_suffix.size() &&
+                   name.compare(name.size() - kernel_suffix.size(), kernel_suffix.size(), kernel_suffix) == 0) {
+            std::string node_name = name.substr(0, name.size() - kernel_suffix.size());
+            std::string op_type = profile_detail::find_field(event, "op_name");
+            double output_bytes = profile_detail::find_number(event, "output_size");
+            double activation_bytes = profile_detail::find_number(event, "activation_size");
+            double parameter_bytes = profile_detail::find_number(event, "parameter_size");
+            profile_detail::add_sample(summary.by_op_type[op_type], op_type, op_type, dur,
+                                       output_bytes, activation_bytes, parameter_bytes);
+            profile_detail::add_sample(summary.by_node[node_name], node_name + " (" + op_type + ")", op_type, dur,
+                                       output_bytes, activation_bytes, parameter_bytes);
+        }
+    }
+
+    // Weights belong to nodes, not calls: an operator type uses the sum over its nodes.
+    for (auto& entry : summary.by_op_type) {
+        entry.second.parameter_bytes = 0.0;
+    }
+    for (const auto& entry : summary.by_node) {
+        summary.by_op_type[entry.second.op_type].parameter_bytes += entry.second.parameter_bytes;
+    }
+    return summary;
+}
+
+// Prints one table of rows sorted by total time, limited to max_rows entries.
+inline void print_profile_table(const char* title, const std::map<std::string, ProfileRow>& rows,
+                                double model_run_us, size_t max_rows) {
+    std::vector<const ProfileRow*> sorted;
+    for (const auto& entry : rows) {
+        sorted.push_back(&entry.second);
+    }
+    std::sort(sorted.begin(), sorted.end(), [](const ProfileRow* a, const ProfileRow* b) {
+        return a->total_us > b->total_us;
+    });
+
+    std::cout << "\n--- " << title << " ---" << std::endl;
+    std::cout << std::left << std::setw(40) << "Name" << std::right
+              << std::setw(12) << "Total(us)" << std::setw(8) << "Calls"
+              << std::setw(10) << "Share" << std::setw(14) << "Out bytes"
+              << std::setw(14) << "Param bytes" << std::endl;
+    for (size_t i = 0; i < sorted.size() && i < max_rows; ++i) {
+        const ProfileRow& row = *sorted[i];
+        double share = model_run_us > 0.0 ? 100.0 * row.total_us / model_run_us : 0.0;
+        std::cout << std::left << std::setw(40) << row.name << std::right << std::fixed << std::setprecision(1)
+                  << std::setw(12) << row.total_us << std::setw(8) << row.calls
+                  << std::setw(9) << share << "%"
+                  << std::setw(14) << std::setprecision(0) << row.output_bytes / (row.calls ? row.calls : 1)
+                  << std::setw(14) << row.parameter_bytes << std::endl;
+        std::cout.unsetf(std::ios::fixed);
+        std::cout << std::setprecision(6);
+    }
+    if (sorted.size() > max_rows) {
+        std::cout << "(" << sorted.size() - max_rows << " more not shown)" << std::endl;
+    }
+}
+
+inline void print_profile_summary(const ProfileSummary& summary, size_t max_nodes = 20) {
+    std::cout << "\n--- Profile Summary ---" << std::endl;
+    std::cout << "Runs: " << summary.runs << std::endl;
+    std::cout << "Total model_run time: " << summary.model_run_us << " us";
+    if (summary.runs > 0) {
+        std::cout << " (" << summary.model_run_us / summary.runs << " us per run)";
+    }
+    std::cout << std::endl;
+
+    double output_bytes = 0.0;
+    double activation_bytes = 0.0;
+    double parameter_bytes = 0.0;
+    for (const auto& entry : summary.by_node) {
+        const ProfileRow& row = entry.second;
+        output_bytes += row.output_bytes / (row.calls ? row.calls : 1);
+        activation_bytes = std::max(activation_bytes, row.activation_bytes);
+        parameter_bytes += row.parameter_bytes;
+    }
+    std::cout << "Node output bytes per run: " << output_bytes << " (parameters: "
+              << parameter_bytes << " bytes, largest activation: " << activation_bytes << " bytes)" << std::endl;
+
+    print_profile_table("Time by Operator Type", summary.by_op_type, summary.model_run_us, summary.by_op_type.size());
+    print_profile_table("Time by Node", summary.by_node, summary.model_run_us, max_nodes);
+}
@@ -0,0 +1,212 @@
+#include <iostream> // For standard input/output operations (e.g., std::cout, std::cerr)
+#include <vector>   // For std::vector to hold request batches
+#include <string>   // For std::string to handle argument parsing
+#include <cstdlib>  // For EXIT_FAILURE/EXIT_SUCCESS
+#include <cstring>  // For std::strcmp
+#include <chrono>   // For timing requests
+#include <thread>   // For the synchronous caller threads
+#include <mutex>    // For collecting latencies from callbacks
+#include <atomic>   // For the failure counter
+#include <cmath>    // For std::round
+#include <algorithm> // For std::max
+#include <stdexcept> // For std::invalid_argument
+
+// ONNX Runtime C++ API header file
+#include <onnxruntime_cxx_api.h>
+
+#include "async_runner.h"
+#include "latency_stats.h"
+
+// Compares blocking session.Run calls against AsyncRunner at the same core count.
+//
+//   sync, 1 caller:   one thread calls Run for every request, one at a time.
+//   sync, N callers:  N threads (one per concurrent request) each call Run.
+//   async, 1 caller:  one event-loop thread submits every request to
+//                     AsyncRunner and handles the results in callbacks.
+//
+// The session uses N intra-op threads in every case, which RunAsync also
+// uses to execute the requests.
+//
+//   ./linear_async --threads 4 --requests 20000 --batch 16
+//   ./linear_async --backend workers --max-in-flight 256
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct RunResult {
+    LatencyStats latency;
+    double wall_seconds = 0.0;
+    size_t failures = 0;
+};
+
+// The request batch for request number `index`.
+std::vector<float> make_request(size_t index, size_t batch_size) {
+    std::vector<float> input(batch_size);
+    for (size_t i = 0; i < batch_size; ++i) {
+        input[i] = static_cast<float>((index + i) % 1000);
+    }
+    return input;
+}
+
+bool output_matches(const std::vector<float>& input, const std::vector<float>& output) {
+    return output.size() == input.size() && !input.empty() &&
+           std::round(output.back()) == std::round(input.back() * 2.0f);
+}
+
+// num_callers threads split the requests and each calls Run synchronously.
+RunResult run_sync(Ort::Session& session, int num_callers, size_t num_requests, size_t batch_size) {
+    std::vector<LatencyStats> per_thread(num_callers);
+    std::vector<size_t> failures(num_callers, 0);
+    std::vector<std::thread> callers;
+
+    auto begin = Clock::now();
+    for (int c = 0; c < num_callers; ++c) {
+        callers.emplace_back([&, c] {
+            auto memory_info = Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
+            const char* input_name = "input";
+            const char* output_name = "output";
+            std::vector<float> output(batch_size);
+            int64_t shape[2] = {static_cast<int64_t>(batch_size), 1};
+            for (size_t r = c; r < num_requests; r += num_callers) {
+                auto request_begin = Clock::now();
+                std::vector<float> input = make_request(r, batch_size);
+                Ort::Value input_tensor = Ort::Value::CreateTensor<float>(memory_info, input.data(), batch_size, shape, 2);
+                Ort::Value output_tensor = Ort::Value::CreateTensor<float>(memory_info, output.data(), batch_size, shape, 2);
+                session.Run(Ort::RunOptions{nullptr}, &input_name, &input_tensor, 1, &output_name, &output_tensor, 1);
+                per_thread[c].add(std::chrono::duration<double, std::micro>(Clock::now() - request_begin).count());
+                if (!output_matches(input, output)) {
+                    failures[c] += 1;
+                }
+            }
+        });
+    }
+    for (auto& caller : callers) {
+        caller.join();
+    }
+
+    RunResult result;
+    result.wall_seconds = std::chrono::duration<double>(Clock::now() - begin).count();
+    for (int c = 0; c < num_callers; ++c) {
+        for (double sample : per_thread[c].samples()) {
+            result.latency.add(sample);
+        }
+        result.failures += failures[c];
+    }
+    return result;
+}
+
+// One thread submits every request; results arrive in callbacks.
+RunResult run_async(AsyncRunner& runner, size_t num_requests, size_t batch_size) {
+    RunResult result;
+    std::mutex result_mutex;
+    result.latency.reserve(num_requests);
+
+    auto begin = Clock::now();
+    for (size_t r = 0; r < num_requests; ++r) {
+        auto request_begin = Clock::now();
+        std::vector<float> input = make_request(r, batch_size);
+        float last_input = input.back();
+        runner.submit(std::move(input), [&, request_begin, last_input](std::vector<float> output, std::exception_ptr error) {
+            double latency_us = std::chrono::duration<double, std::micro>(Clock::now() - request_begin).count();
+            bool ok = !error && !output.empty() && std::round(output.back()) == std::round(last_input * 2.0f);
+            std::lock_guard<std::mutex> lock(result_mutex);
+            result.latency.add(latency_us);
+            result.failures += ok ? 0 : 1;
+        });
+    }
+    runner.drain();
+    result.wall_seconds = std::chrono::duration<double>(Clock::now() - begin).count();
+    return result;
+}
+
+void print_result(const char* title, const RunResult& result) {
+    std::cout << "\n--- " << title << " ---" << std::endl;
+    result.latency.print(std::cout, result.wall_seconds);
+    std::cout << "Test " << (result.failures == 0 ? "PASSED" : "FAILED")
+              << " (" << result.failures << " mismatches)" << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    const char* model_path = "data/linear/linear.onnx";
+    int threads = static_cast<int>(std::max(2u, std::thread::hardware_concurrency()));
+    size_t num_requests = 20000;
+    size_t batch_size = 16;
+    AsyncRunner::Options options;
+
+    try {
+        for (int i = 1; i < argc; ++i) {
+            if (std::strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+                threads = std::stoi(argv[++i]);
+            } else if (std::strcmp(argv[i], "--requests") == 0 && i + 1 < argc) {
+                num_requests = std::stoul(argv[++i]);
+            } else if (std::strcmp(argv[i], "--batch") == 0 && i + 1 < argc) {
+                batch_size = std::stoul(argv[++i]);
+            } else if (std::strcmp(argv[i], "--max-in-flight") == 0 && i + 1 < argc) {
+                options.max_in_flight = std::stoul(argv[++i]);
+            } else if (std::strcmp(argv[i], "--backend") == 0 && i + 1 < argc) {
+                std::string backend = argv[++i];
+                if (backend != "run-async" && backend != "workers") {
+                    throw std::invalid_argument(backend);
+                }
+                options.prefer_run_async = backend == "run-async";
+            } else if (std::strcmp(argv[i], "--model") == 0 && i + 1 < argc) {
+                model_path = argv[++i];
+            } else {
+                throw std::invalid_argument(argv[i]);
+            }
+        }
+    } catch (const std::exception&) {
+        std::cerr << "Usage: " << argv[0] << " [--threads N] [--requests N] [--batch N] [--max-in-flight N]"
+                  << " [--backend run-async|workers] [--model <model_path>]" << std::endl;
+        return EXIT_FAILURE;
+    }
+    if (threads < 2 || num_requests == 0 || batch_size == 0 || options.max_in_flight == 0) {
+        std::cerr << "Error: --threads must be at least 2 (RunAsync needs an intra-op pool);"
+                  << " --requests, --batch and --max-in-flight must be positive." << std::endl;
+        return EXIT_FAILURE;
+    }
+    options.workers = threads;
+
+    try {
+        Ort::Env env(ORT_LOGGING_LEVEL_WARNING, "linear_async");
+        Ort::SessionOptions session_options;
+        session_options.SetIntraOpNumThreads(threads);
+        Ort::Session session(env, model_path, session_options);
+
+        std::cout << "Threads: " << threads << ", requests: " << num_requests
+                  << ", batch: " << batch_size << ", max in flight: " << options.max_in_flight << std::endl;
+
+        RunResult sync_one = run_sync(session, 1, num_requests, batch_size);
+        print_result("sync, 1 caller", sync_one);
+
+        RunResult sync_many = run_sync(session, threads, num_requests, batch_size);
+        print_result("sync, 1 thread per concurrent request", sync_many);
+
+        AsyncRunner runner(session, options);
+        RunResult async = run_async(runner, num_requests, batch_size);
+        print_result((std::string("async (") + runner.backend_name() + "), 1 caller").c_str(), async);
+        std::cout << "Peak in flight: " << runner.peak_in_flight() << std::endl;
+
+        double sync_rate = num_requests / sync_one.wall_seconds;
+        double sync_many_rate = num_requests / sync_many.wall_seconds;
+        double async_rate = num_requests / async.wall_seconds;
+        std::cout << "\nAsync throughput vs sync, 1 caller: " << async_rate / sync_rate << "x"
+                  << ", vs sync, " << threads << " callers: " << async_rate / sync_many_rate << "x" << std::endl;
+
+        if (sync_one.failures != 0 || sync_many.failures != 0 || async.failures != 0) {
+            return EXIT_FAILURE;
+        }
+
+    } catch (const Ort::Exception& ex) {
+        std::cerr << "ONNX Runtime Error: " << ex.what() << std::endl;
+        return EXIT_FAILURE;
+    } catch (const std::exception& ex) {
+        std::cerr << "Standard C++ Error: " << ex.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,248 @@
+#pragma once
+
+#include <algorithm>          // For std::max
+#include <condition_variable> // For in-flight limits and the worker queue
+#include <cstdint>            // For int64_t shapes
+#include <deque>              // For the worker queue
+#include <exception>          // For std::exception_ptr
+#include <functional>         // For std::function callbacks
+#include <future>             // For std::promise/std::future results
+#include <memory>             // For std::unique_ptr, std::shared_ptr
+#include <mutex>              // For protecting the counters and queue
+#include <string>             // For the input/output names
+#include <thread>             // For the fallback worker threads
+#include <vector>             // For the request buffers
+
+// ONNX Runtime C++ API header file
+#include <onnxruntime_cxx_api.h>
+
+// Non-blocking inference for a model with one [N, 1] float input and output.
+//
+// submit() returns right away and either calls a callback or fulfils a
+// std::future when the result is ready, so a single event-loop thread can keep
+// thousands of requests in flight without a thread per request.
+//
+// With ONNX Runtime 1.16+ requests go through Session::RunAsync, which runs
+// them on the session's intra-op thread pool; that pool must have at least two
+// threads (SetIntraOpNumThreads(n) with n >= 2), otherwise RunAsync fails.
+// Older versions, or Options::prefer_run_async = false, use a small pool of
+// worker threads calling the blocking Run instead. Callbacks run on those ORT
+// or worker threads, so they should be short and must not throw.
+class AsyncRunner {
+public:
+    using Callback = std::function<void(std::vector<float> output, std::exception_ptr error)>;
+
+    enum class Backend { RunAsync, WorkerPool };
+
+    struct Options {
+        size_t max_in_flight = 1024;  // submit() blocks while this many requests are pending.
+        size_t workers = 0;           // Worker threads for the fallback (0 = hardware concurrency).
+        bool prefer_run_async = true; // Use Session::RunAsync when the ORT version has it.
+    };
+
+    // The session must outlive the runner.
+    AsyncRunner(Ort::Session& session, Options options,
+                const char* input_name = "input", const char* output_name = "output")
+        : session_(session),
+          options_(options),
+          input_name_(input_name),
+          output_name_(output_name),
+          memory_info_(Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault)) {
+        if (options_.max_in_flight == 0) {
+            options_.max_in_flight = 1;
+        }
+#if ORT_API_VERSION >= 16
+        backend_ = options_.prefer_run_async ? Backend::RunAsync : Backend::WorkerPool;
+#else
+        backend_ = Backend::WorkerPool;
+#endif
+        if (backend_ == Backend::WorkerPool) {
+            size_t workers = options_.workers != 0 ? options_.workers
+                                                   : std::max(1u, std::thread::hardware_concurrency());
+            for (size_t i = 0; i < workers; ++i) {
+                workers_.emplace_back(&AsyncRunner::worker_loop, this);
+            }
+        }
+    }
+
+    // Waits for every pending request, then stops the workers.
+    ~AsyncRunner() {
+        drain();
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        queue_cv_.notify_all();
+        for (auto& worker : workers_) {
+            worker.join();
+        }
+    }
+
+    AsyncRunner(const AsyncRunner&) = delete;
+    AsyncRunner& operator=(const AsyncRunner&) = delete;
+
+    // Starts inference on `input` (a batch of input.size() rows) and calls
+    // `callback` with the outputs, or with an exception if the run failed.
+    void submit(std::vector<float> input, Callback callback) {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            slot_cv_.wait(lock, [this] { return in_flight_ < options_.max_in_flight; });
+            ++in_flight_;
+            peak_in_flight_ = std::max(peak_in_flight_, in_flight_);
+        }
+
+        std::unique_ptr<Request> request(new Request);
+        request->runner = this;
+        request->input = std::move(input);
+        request->output.resize(request->input.size());
+        request->callback = std::move(callback);
+        try {
+            int64_t shape[2] = {static_cast<int64_t>(request->input.size()), 1};
+            request->input_tensor = Ort::Value::CreateTensor<float>(
+                memory_info_, request->input.data(), request->input.size(), shape, 2);
+            request->output_tensor = Ort::Value::CreateTensor<float>(
+                memory_info_, request->output.data(), request->output.size(), shape, 2);
+        } catch (...) {
+            complete(request.release(), std::current_exception());
+            return;
+        }
+
+        if (backend_ == Backend::WorkerPool) {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                queue_.push_back(std::move(request));
+            }
+            queue_cv_.notify_one();
+            return;
+        }
+
+#if ORT_API_VERSION >= 16
+        const char* input_name = input_name_.c_str();
+        const char* output_name = output_name_.c_str();
+        try {
+            session_.RunAsync(run_options_, &input_name, &request->input_tensor, 1,
+                              &output_name, &request->output_tensor, 1,
+                              &AsyncRunner::on_run_async_done, request.get());
+            request.release(); // Owned by the callback from here on.
+        } catch (...) {
+            complete(request.release(), std::current_exception());
+        }
+#endif
+    }
+
+    // Future-based variant of submit().
+    std::future<std::vector<float>> submit(std::vector<float> input) {
+        auto promise = std::make_shared<std::promise<std::vector<float>>>();
+        std::future<std::vector<float>> result = promise->get_future();
+        submit(std::move(input), [promise](std::vector<float> output, std::exception_ptr error) {
+            if (error) {
+                promise->set_exception(error);
+            } else {
+                promise->set_value(std::move(output));
+            }
+        });
+        return result;
+    }
+
+    // Blocks until every submitted request has completed.
+    void drain() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        slot_cv_.wait(lock, [this] { return in_flight_ == 0; });
+    }
+
+    Backend backend() const { return backend_; }
+    const char* backend_name() const { return backend_ == Backend::RunAsync ? "RunAsync" : "worker pool"; }
+
+    // Requests submitted but not yet completed, and the most seen at once.
+    size_t in_flight() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return in_flight_;
+    }
+    size_t peak_in_flight() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return peak_in_flight_;
+    }
+
+private:
+    struct Request {
+        AsyncRunner* runner = nullptr;
+        std::vector<float> input;
+        std::vector<float> output;
+        Ort::Value input_tensor{nullptr};
+        Ort::Value output_tensor{nullptr};
+        Callback callback;
+    };
+
+#if ORT_API_VERSION >= 16
+    // Called by ORT on one of its intra-op threads. The outputs are the
+    // request's own output_tensor, which ORT filled in place.
+    static void on_run_async_done(void* user_data, OrtValue** /*outputs*/, size_t /*num_outputs*/,
+                                  OrtStatusPtr status) {
+        Request* request = static_cast<Request*>(user_data);
+        Ort::Status run_status(status); // Takes ownership of the status.
+        std::exception_ptr error;
+        if (!run_status.IsOK()) {
+            error = std::make_exception_ptr(Ort::Exception(run_status.GetErrorMessage(), run_status.GetErrorCode()));
+        }
+        request->runner->complete(request, error);
+    }
+#endif
+
+    void worker_loop() {
+        const char* input_name = input_name_.c_str();
+        const char* output_name = output_name_.c_str();
+        while (true) {
+            std::unique_ptr<Request> request;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                queue_cv_.wait(lock, [this] { return stopping_ || !queue_.empty(); });
+                if (queue_.empty()) {
+                    return; // Stopping and nothing left to serve.
+                }
+                request = std::move(queue_.front());
+                queue_.pop_front();
+            }
+            std::exception_ptr error;
+            try {
+                session_.Run(run_options_, &input_name, &request->input_tensor, 1,
+                             &output_name, &request->output_tensor, 1);
+            } catch (...) {
+                error = std::current_exception();
+            }
+            complete(request.release(), error);
+        }
+    }
+
+    // Hands the result to the caller and frees the in-flight slot.
+    void complete(Request* request, std::exception_ptr error) {
+        std::unique_ptr<Request> owned(request);
+        try {
+            owned->callback(error ? std::vector<float>() : std::move(owned->output), error);
+        } catch (...) {
+            // Callbacks must not throw; there is nobody to report to on this thread.
+        }
+        owned.reset();
+        // Notify under the lock: once in_flight_ reaches 0 the destructor may run,
+        // and slot_cv_ must not be touched after that.
+        std::lock_guard<std::mutex> lock(mutex_);
+        --in_flight_;
+        slot_cv_.notify_all();
+    }
+
+    Ort::Session& session_;
+    Options options_;
+    std::string input_name_;
+    std::string output_name_;
+    Ort::MemoryInfo memory_info_;
+    Ort::RunOptions run_options_;
+    Backend backend_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable slot_cv_;  // in_flight_ went down.
+    std::condition_variable queue_cv_; // queue_ got work or stopping_ was set.
+    size_t in_flight_ = 0;
+    size_t peak_in_flight_ = 0;
+    std::deque<std::unique_ptr<Request>> queue_;
+    bool stopping_ = false;
+    std::vector<std::thread> workers_;
+};
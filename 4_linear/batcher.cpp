@@ -0,0 +1,169 @@
+#include <iostream> // For standard input/output operations (e.g., std::cout, std::cerr)
+#include <vector>   // For std::vector to hold per-thread results
+#include <string>   // For std::string to handle argument parsing
+#include <cstdlib>  // For std::stoi and EXIT_FAILURE/EXIT_SUCCESS
+#include <cstring>  // For std::strcmp
+#include <chrono>   // For timing requests
+#include <thread>   // For the client threads
+#include <exception> // For passing errors out of the client threads
+#include <cmath>    // For std::round
+
+// ONNX Runtime C++ API header file
+#include <onnxruntime_cxx_api.h>
+
+#include "latency_stats.h"
+#include "micro_batcher.h"
+
+// Compares one session.Run per request against MicroBatcher, which coalesces
+// concurrent requests from many client threads into one [N, 1] Run.
+//
+//   ./linear_batcher --clients 16 --requests 10000 --max-batch 64 --max-wait-us 500
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct RunResult {
+    LatencyStats latency;
+    double wall_seconds = 0.0;
+    size_t failures = 0;
+};
+
+// Starts num_clients threads that each issue requests_per_client calls to
+// predict(value) one after another, and collects their latencies. If predict
+// throws on any thread, the first such exception is rethrown once all threads
+// have finished.
+template <typename PredictFn>
+RunResult run_clients(int num_clients, int requests_per_client, PredictFn predict) {
+    std::vector<LatencyStats> per_thread(num_clients);
+    std::vector<size_t> failures(num_clients, 0);
+    std::vector<std::exception_ptr> errors(num_clients);
+    std::vector<std::thread> clients;
+
+    auto begin = Clock::now();
+    for (int c = 0; c < num_clients; ++c) {
+        clients.emplace_back([&, c] {
+            try {
+                per_thread[c].reserve(requests_per_client);
+                for (int i = 0; i < requests_per_client; ++i) {
+                    float input_value = static_cast<float>((c * requests_per_client + i) % 1000);
+                    auto request_begin = Clock::now();
+                    float output_value = predict(input_value);
+                    per_thread[c].add(std::chrono::duration<double, std::micro>(Clock::now() - request_begin).count());
+                    if (std::round(output_value) != std::round(input_value * 2.0f)) {
+                        failures[c] += 1;
+                    }
+                }
+            } catch (...) {
+                errors[c] = std::current_exception();
+            }
+        });
+    }
+    for (auto& client : clients) {
+        client.join();
+    }
+    for (const std::exception_ptr& error : errors) {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+
+    RunResult result;
+    result.wall_seconds = std::chrono::duration<double>(Clock::now() - begin).count();
+    for (int c = 0; c < num_clients; ++c) {
+        for (double sample : per_thread[c].samples()) {
+            result.latency.add(sample);
+        }
+        result.failures += failures[c];
+    }
+    return result;
+}
+
+void print_result(const char* title, const RunResult& result) {
+    std::cout << "\n--- " << title << " ---" << std::endl;
+    result.latency.print(std::cout, result.wall_seconds);
+    std::cout << "Test " << (result.failures == 0 ? "PASSED" : "FAILED")
+              << " (" << result.failures << " mismatches)" << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    const char* model_path = "data/linear/linear.onnx";
+    int num_clients = 16;
+    int requests_per_client = 10000;
+    MicroBatcher::Options options;
+
+    try {
+        for (int i = 1; i < argc; ++i) {
+            if (std::strcmp(argv[i], "--clients") == 0 && i + 1 < argc) {
+                num_clients = std::stoi(argv[++i]);
+            } else if (std::strcmp(argv[i], "--requests") == 0 && i + 1 < argc) {
+                requests_per_client = std::stoi(argv[++i]);
+            } else if (std::strcmp(argv[i], "--max-batch") == 0 && i + 1 < argc) {
+                options.max_batch_size = std::stoul(argv[++i]);
+            } else if (std::strcmp(argv[i], "--max-wait-us") == 0 && i + 1 < argc) {
+                options.max_wait = std::chrono::microseconds(std::stol(argv[++i]));
+            } else if (std::strcmp(argv[i], "--model") == 0 && i + 1 < argc) {
+                model_path = argv[++i];
+            } else {
+                throw std::invalid_argument(argv[i]);
+            }
+        }
+    } catch (const std::exception&) {
+        std::cerr << "Usage: " << argv[0] << " [--clients N] [--requests N] [--max-batch N]"
+                  << " [--max-wait-us N] [--model <model_path>]" << std::endl;
+        return EXIT_FAILURE;
+    }
+    if (num_clients <= 0 || requests_per_client <= 0 || options.max_batch_size == 0) {
+        std::cerr << "Error: --clients, --requests and --max-batch must be positive." << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    try {
+        Ort::Env env(ORT_LOGGING_LEVEL_WARNING, "linear_batcher");
+        Ort::Session session(env, model_path, Ort::SessionOptions());
+        auto memory_info = Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
+
+        std::cout << "Clients: " << num_clients << ", requests per client: " << requests_per_client
+                  << ", max batch: " << options.max_batch_size
+                  << ", max wait: " << options.max_wait.count() << " us" << std::endl;
+
+        // --- 1. Baseline: every client calls session.Run itself (Run is thread-safe) ---
+        RunResult unbatched = run_clients(num_clients, requests_per_client, [&](float input_value) {
+            int64_t shape[2] = {1, 1};
+            float output_value = 0.0f;
+            Ort::Value input_tensor = Ort::Value::CreateTensor<float>(memory_info, &input_value, 1, shape, 2);
+            Ort::Value output_tensor = Ort::Value::CreateTensor<float>(memory_info, &output_value, 1, shape, 2);
+            const char* input_name = "input";
+            const char* output_name = "output";
+            session.Run(Ort::RunOptions{nullptr}, &input_name, &input_tensor, 1, &output_name, &output_tensor, 1);
+            return output_value;
+        });
+        print_result("One Run per request", unbatched);
+
+        // --- 2. Micro-batched: requests are coalesced by the batcher ---
+        MicroBatcher batcher(session, options);
+        RunResult batched = run_clients(num_clients, requests_per_client, [&](float input_value) {
+            return batcher.submit(input_value).get();
+        });
+        print_result("Micro-batched", batched);
+        if (batcher.batches_run() > 0) {
+            std::cout << "Average batch size: "
+                      << static_cast<double>(batcher.requests_served()) / batcher.batches_run() << std::endl;
+        }
+
+        if (unbatched.failures != 0 || batched.failures != 0) {
+            return EXIT_FAILURE;
+        }
+
+    } catch (const Ort::Exception& ex) {
+        std::cerr << "ONNX Runtime Error: " << ex.what() << std::endl;
+        return EXIT_FAILURE;
+    } catch (const std::exception& ex) {
+        std::cerr << "Standard C++ Error: " << ex.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
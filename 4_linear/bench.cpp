@@ -0,0 +1,366 @@
+#include <iostream> // For standard input/output operations (e.g., std::cout, std::cerr)
+#include <fstream>  // For writing the report to a file
+#include <sstream>  // For splitting comma separated lists
+#include <vector>   // For std::vector to hold inputs and results
+#include <string>   // For std::string to handle names and argument parsing
+#include <cstdlib>  // For EXIT_FAILURE/EXIT_SUCCESS
+#include <cstring>  // For std::strcmp
+#include <chrono>   // For timing the runs
+#include <random>   // For the mixed batch sizes of the bucket comparison
+
+// ONNX Runtime C++ API header file
+#include <onnxruntime_cxx_api.h>
+
+#include "inference_runner.h"
+#include "latency_stats.h"
+#include "process_stats.h"
+#include "session_pool.h"
+#include "shape_buckets.h"
+#include "synthetic_inputs.h"
+
+// Latency/throughput benchmark for linear.onnx or any other model. Inputs are
+// random tensors of each input's own type (SyntheticInputs, synthetic_inputs.h).
+//
+// Sweeps batch sizes, intra-op thread counts and session option variants, and
+// reports mean/p50/p95/p99 latency (warm-up runs excluded), items/sec and
+// memory for every combination as CSV or JSON. rss_kb is the process's
+// current RSS right after the timed runs, while the session is still alive;
+// rss_growth_kb is how much it grew since just before the session was created.
+// (The process-lifetime peak, getrusage's ru_maxrss, would repeat the largest
+// configuration's value on every later row.)
+//
+//   ./linear_bench
+//   ./linear_bench model.onnx --batches 1,64,4096 --threads 1,4 --variants default,no-spin --format json
+//
+// With --buckets, requests instead get random batch sizes up to the largest
+// bucket, and two rows are reported per variant/thread count:
+//   "<variant>+exact":   every request runs at its own batch size, so each new
+//                        size pays for allocation planning (cold spikes).
+//                        It uses the same IoBinding runner as "+buckets",
+//                        with one bucket per requested size.
+//   "<variant>+buckets": every bucket is warmed up first and requests are
+//                        padded to the nearest bucket (see shape_buckets.h).
+//
+//   ./linear_bench --buckets 1,8,64,512,4096 --iterations 2000
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct BenchConfig {
+    std::string model_path = "data/linear/linear.onnx";
+    std::vector<size_t> batch_sizes = {1, 4, 16, 64, 256, 1024, 4096, 16384, 65536};
+    std::vector<int> thread_counts = {1, 2, 4};
+    std::vector<std::string> variants = {"default"};
+    int warmup = 20;
+    int iterations = 200;
+    std::string format = "csv";
+    std::string output_path; // Empty: write to stdout.
+    std::string buckets;     // Non-empty: compare exact shapes against these buckets.
+};
+
+struct BenchResult {
+    std::string variant;
+    size_t batch_size;
+    int threads;
+    double mean_us, p50_us, p95_us, p99_us;
+    double items_per_sec;
+    long rss_kb;
+    long rss_growth_kb;
+};
+
+template <typename T>
+std::vector<T> parse_list(const std::string& text) {
+    std::vector<T> values;
+    std::stringstream stream(text);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        std::stringstream item_stream(item);
+        T value;
+        if (!(item_stream >> value)) {
+            throw std::invalid_argument("invalid list item: " + item);
+        }
+        values.push_back(value);
+    }
+    return values;
+}
+
+// Applies a named session option variant on top of the thread count.
+SessionPoolOptions make_options(const std::string& variant, int threads) {
+    SessionPoolOptions options;
+    options.num_runners = 1;
+    options.intra_op_threads = threads;
+    if (variant == "default") {
+        // ORT_ENABLE_ALL, spinning on, per-session threads.
+    } else if (variant == "no-spin") {
+        options.allow_spinning = false;
+    } else if (variant == "global-pool") {
+        options.use_global_thread_pool = true;
+    } else if (variant == "basic-opt") {
+        options.optimization_level = ORT_ENABLE_BASIC;
+    } else if (variant == "no-opt") {
+        options.optimization_level = ORT_DISABLE_ALL;
+    } else if (variant == "env-arena") {
+        options.use_env_allocator = true;
+        options.arena_extend_strategy = 1; // Grow by what is requested, not to the next power of two.
+    } else {
+        throw std::invalid_argument("unknown variant: " + variant +
+                                    " (expected default, no-spin, global-pool, basic-opt, no-opt or env-arena)");
+    }
+    return options;
+}
+
+long to_kb(size_t bytes) {
+    return static_cast<long>(bytes / 1024);
+}
+
+// rss_before is current_rss_bytes() from before the configuration's session was created.
+BenchResult make_result(const std::string& variant, int threads, size_t batch_size,
+                        const LatencyStats& stats, double items_per_sec, size_t rss_before) {
+    BenchResult result;
+    result.variant = variant;
+    result.batch_size = batch_size;
+    result.threads = threads;
+    result.mean_us = stats.mean();
+    result.p50_us = stats.percentile(50);
+    result.p95_us = stats.percentile(95);
+    result.p99_us = stats.percentile(99);
+    result.items_per_sec = items_per_sec;
+    size_t rss = current_rss_bytes();
+    result.rss_kb = to_kb(rss);
+    result.rss_growth_kb = rss >= rss_before ? to_kb(rss - rss_before) : -to_kb(rss_before - rss);
+    return result;
+}
+
+BenchResult run_one(const BenchConfig& config, const std::string& variant, int threads, size_t batch_size) {
+    size_t rss_before = current_rss_bytes();
+    SessionPool pool(config.model_path.c_str(), make_options(variant, threads));
+    SessionPool::Lease lease = pool.acquire();
+    Ort::Session& session = lease.session();
+    // Random inputs of the model's own types; the first dynamic dimension is the batch.
+    SyntheticInputs inputs(session, DimOverrides::batch(static_cast<int64_t>(batch_size)));
+
+    auto run = [&] { inputs.run(session); };
+
+    for (int i = 0; i < config.warmup; ++i) {
+        run();
+    }
+
+    LatencyStats stats;
+    stats.reserve(config.iterations);
+    auto begin = Clock::now();
+    for (int i = 0; i < config.iterations; ++i) {
+        auto run_begin = Clock::now();
+        run();
+        stats.add(std::chrono::duration<double, std::micro>(Clock::now() - run_begin).count());
+    }
+    double wall_seconds = std::chrono::duration<double>(Clock::now() - begin).count();
+    return make_result(variant, threads, batch_size, stats,
+                       config.iterations * static_cast<double>(batch_size) / wall_seconds, rss_before);
+}
+
+// Random batch sizes in [1, largest], the same sequence for every run.
+std::vector<size_t> mixed_batch_sizes(size_t count, size_t largest) {
+    std::mt19937 rng(1234);
+    std::uniform_int_distribution<size_t> dist(1, largest);
+    std::vector<size_t> sizes(count);
+    for (size_t& size : sizes) {
+        size = dist(rng);
+    }
+    return sizes;
+}
+
+// Runs mixed-size requests once at their exact batch size on a fresh session,
+// and once padded to warmed-up shape buckets on another fresh session.
+std::vector<BenchResult> run_bucket_comparison(const BenchConfig& config, const std::string& variant, int threads) {
+    ShapeBuckets buckets = ShapeBuckets::parse(config.buckets);
+    std::vector<size_t> warmup_sizes = mixed_batch_sizes(config.warmup, buckets.largest());
+    std::vector<size_t> sizes = mixed_batch_sizes(config.iterations + config.warmup, buckets.largest());
+    sizes.erase(sizes.begin(), sizes.begin() + config.warmup); // Timed requests differ from the warm-up ones.
+    std::vector<float> input(buckets.largest());
+    std::vector<float> output(buckets.largest());
+    for (size_t i = 0; i < input.size(); ++i) {
+        input[i] = static_cast<float>(i % 100);
+    }
+    double items = 0.0;
+    for (size_t size : sizes) {
+        items += static_cast<double>(size);
+    }
+    std::vector<BenchResult> results;
+
+    // --- Before: exact shapes, only the usual warm-up ---
+    // One bucket per requested size, so nothing is padded, and the same
+    // IoBinding path as below: the two rows differ only in which shapes the
+    // session has seen before the timed requests.
+    {
+        std::vector<size_t> exact_sizes = sizes;
+        exact_sizes.insert(exact_sizes.end(), warmup_sizes.begin(), warmup_sizes.end());
+        size_t rss_before = current_rss_bytes();
+        SessionPool pool(config.model_path.c_str(), make_options(variant, threads));
+        SessionPool::Lease lease = pool.acquire();
+        InferenceRunner metadata(lease.session()); // Supplies the input/output names.
+        BucketedRunner runner(lease.session(), ShapeBuckets(exact_sizes), metadata.inputs().at(0).name.c_str(),
+                              metadata.outputs().at(0).name.c_str());
+        for (size_t size : warmup_sizes) {
+            runner.run(input.data(), size, output.data());
+        }
+        LatencyStats stats;
+        stats.reserve(sizes.size());
+        auto begin = Clock::now();
+        for (size_t size : sizes) {
+            auto run_begin = Clock::now();
+            runner.run(input.data(), size, output.data());
+            stats.add(std::chrono::duration<double, std::micro>(Clock::now() - run_begin).count());
+        }
+        double wall_seconds = std::chrono::duration<double>(Clock::now() - begin).count();
+        results.push_back(make_result(variant + "+exact", threads, buckets.largest(), stats, items / wall_seconds, rss_before));
+    }
+
+    // --- After: every bucket warmed up, requests padded to the nearest bucket ---
+    {
+        size_t rss_before = current_rss_bytes();
+        SessionPool pool(config.model_path.c_str(), make_options(variant, threads));
+        SessionPool::Lease lease = pool.acquire();
+        InferenceRunner metadata(lease.session()); // Supplies the input/output names.
+        BucketedRunner runner(lease.session(), buckets, metadata.inputs().at(0).name.c_str(),
+                              metadata.outputs().at(0).name.c_str());
+        runner.warm_up();
+        for (size_t size : warmup_sizes) {
+            runner.run(input.data(), size, output.data());
+        }
+        size_t padded_before = runner.padded_rows();
+        LatencyStats stats;
+        stats.reserve(sizes.size());
+        auto begin = Clock::now();
+        for (size_t size : sizes) {
+            auto run_begin = Clock::now();
+            runner.run(input.data(), size, output.data());
+            stats.add(std::chrono::duration<double, std::micro>(Clock::now() - run_begin).count());
+        }
+        double wall_seconds = std::chrono::duration<double>(Clock::now() - begin).count();
+        results.push_back(make_result(variant + "+buckets", threads, buckets.largest(), stats, items / wall_seconds, rss_before));
+        std::cerr << "  p99 " << results[0].p99_us << " us (exact) -> " << results[1].p99_us
+                  << " us (buckets), padding overhead "
+                  << 100.0 * (runner.padded_rows() - padded_before) / items << "% rows" << std::endl;
+    }
+    return results;
+}
+
+void write_csv(std::ostream& os, const std::vector<BenchResult>& results) {
+    os << "variant,batch_size,threads,mean_us,p50_us,p95_us,p99_us,items_per_sec,rss_kb,rss_growth_kb\n";
+    for (const auto& r : results) {
+        os << r.variant << ',' << r.batch_size << ',' << r.threads << ','
+           << r.mean_us << ',' << r.p50_us << ',' << r.p95_us << ',' << r.p99_us << ','
+           << r.items_per_sec << ',' << r.rss_kb << ',' << r.rss_growth_kb << '\n';
+    }
+}
+
+void write_json(std::ostream& os, const BenchConfig& config, const std::vector<BenchResult>& results) {
+    os << "{\n  \"model\": \"" << config.model_path << "\",\n"
+       << "  \"warmup\": " << config.warmup << ",\n"
+       << "  \"iterations\": " << config.iterations << ",\n"
+       << "  \"results\": [\n";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const auto& r = results[i];
+        os << "    {\"variant\": \"" << r.variant << "\", \"batch_size\": " << r.batch_size
+           << ", \"threads\": " << r.threads << ", \"mean_us\": " << r.mean_us
+           << ", \"p50_us\": " << r.p50_us << ", \"p95_us\": " << r.p95_us
+           << ", \"p99_us\": " << r.p99_us << ", \"items_per_sec\": " << r.items_per_sec
+           << ", \"rss_kb\": " << r.rss_kb << ", \"rss_growth_kb\": " << r.rss_growth_kb << "}"
+           << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    os << "  ]\n}\n";
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    BenchConfig config;
+
+    try {
+        for (int i = 1; i < argc; ++i) {
+            if (std::strcmp(argv[i], "--batches") == 0 && i + 1 < argc) {
+                config.batch_sizes = parse_list<size_t>(argv[++i]);
+            } else if (std::strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+                config.thread_counts = parse_list<int>(argv[++i]);
+            } else if (std::strcmp(argv[i], "--variants") == 0 && i + 1 < argc) {
+                config.variants = parse_list<std::string>(argv[++i]);
+            } else if (std::strcmp(argv[i], "--warmup") == 0 && i + 1 < argc) {
+                config.warmup = std::stoi(argv[++i]);
+            } else if (std::strcmp(argv[i], "--iterations") == 0 && i + 1 < argc) {
+                config.iterations = std::stoi(argv[++i]);
+            } else if (std::strcmp(argv[i], "--buckets") == 0 && i + 1 < argc) {
+                config.buckets = argv[++i];
+                ShapeBuckets::parse(config.buckets); // Validate early.
+            } else if (std::strcmp(argv[i], "--format") == 0 && i + 1 < argc) {
+                config.format = argv[++i];
+            } else if (std::strcmp(argv[i], "--output") == 0 && i + 1 < argc) {
+                config.output_path = argv[++i];
+            } else if (argv[i][0] != '-') {
+                config.model_path = argv[i];
+            } else {
+                throw std::invalid_argument(argv[i]);
+            }
+        }
+        if (config.format != "csv" && config.format != "json") {
+            throw std::invalid_argument("--format must be csv or json");
+        }
+        if (config.iterations <= 0 || config.warmup < 0) {
+            throw std::invalid_argument("--iterations must be positive");
+        }
+        for (const auto& variant : config.variants) {
+            make_options(variant, 1); // Reject unknown variants before loading anything.
+        }
+    } catch (const std::exception& ex) {
+        std::cerr << "Error: " << ex.what() << std::endl;
+        std::cerr << "Usage: " << argv[0] << " [model_path] [--batches 1,16,...] [--threads 1,2,...]"
+                  << " [--variants default,no-spin,global-pool,basic-opt,no-opt,env-arena]"
+                  << " [--buckets 1,8,64,...] [--warmup N] [--iterations N] [--format csv|json] [--output <file>]" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    try {
+        std::vector<BenchResult> results;
+        for (const auto& variant : config.variants) {
+            for (int threads : config.thread_counts) {
+                if (!config.buckets.empty()) {
+                    std::cerr << "Running variant=" << variant << " threads=" << threads
+                              << " buckets=" << config.buckets << "..." << std::endl;
+                    for (const BenchResult& result : run_bucket_comparison(config, variant, threads)) {
+                        results.push_back(result);
+                    }
+                    continue;
+                }
+                for (size_t batch_size : config.batch_sizes) {
+                    std::cerr << "Running variant=" << variant << " threads=" << threads
+                              << " batch=" << batch_size << "..." << std::endl;
+                    results.push_back(run_one(config, variant, threads, batch_size));
+                }
+            }
+        }
+
+        std::ofstream file;
+        if (!config.output_path.empty()) {
+            file.open(config.output_path);
+            if (!file) {
+                std::cerr << "Error: cannot open " << config.output_path << " for writing." << std::endl;
+                return EXIT_FAILURE;
+            }
+        }
+        std::ostream& os = config.output_path.empty() ? std::cout : file;
+        if (config.format == "json") {
+            write_json(os, config, results);
+        } else {
+            write_csv(os, results);
+        }
+
+    } catch (const Ort::Exception& ex) {
+        std::cerr << "ONNX Runtime Error: " << ex.what() << std::endl;
+        return EXIT_FAILURE;
+    } catch (const std::exception& ex) {
+        std::cerr << "Standard C++ Error: " << ex.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
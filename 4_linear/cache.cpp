@@ -0,0 +1,214 @@
+#include <iostream> // For standard input/output operations (e.g., std::cout, std::cerr)
+#include <vector>   // For std::vector to hold requests and results
+#include <string>   // For std::string to handle argument parsing
+#include <cstdlib>  // For EXIT_FAILURE/EXIT_SUCCESS
+#include <cstring>  // For std::strcmp
+#include <chrono>   // For timing the phases
+#include <thread>   // For the client threads
+#include <exception> // For passing errors out of the client threads
+#include <cmath>    // For std::pow
+#include <random>   // For the skewed input mix
+#include <algorithm> // For std::copy, std::equal
+#include <stdexcept> // For std::invalid_argument
+
+// ONNX Runtime C++ API header file
+#include <onnxruntime_cxx_api.h>
+
+#include "inference_runner.h"
+#include "result_cache.h"
+
+// Serves the same skewed stream of batched requests with and without a
+// ResultCache in front of Session::Run.
+//
+// Each request is a batch of --batch rows, and each row is one of --distinct
+// input values, picked with a Zipf-like weight 1 / (k + 1)^skew, so a few
+// values make up most of the traffic. With the cache, every batch is split
+// into rows answered from the cache and rows that still go to the model;
+// the report shows the hit rate, how many rows and Run calls were left, and
+// the throughput of both phases. Every cached output is compared bit for bit
+// with the uncached one.
+//
+//   ./linear_cache --threads 4 --requests 5000 --batch 16 --distinct 1000 --skew 1.0
+//   ./linear_cache --distinct 100000 --entries 1000    (cache too small: watch the evictions)
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct PhaseResult {
+    double seconds = 0.0;
+    size_t rows_run = 0;  // Rows that went through Session::Run.
+    size_t runs = 0;      // Session::Run calls.
+    size_t mismatches = 0;
+};
+
+// Starts num_threads threads; serve(t, result) sends thread t's requests and
+// fills in its rows_run, runs and mismatches. If serve throws on any thread,
+// the first such exception is rethrown once all threads have finished.
+template <typename ServeFn>
+PhaseResult run_phase(int num_threads, ServeFn serve) {
+    std::vector<PhaseResult> per_thread(num_threads);
+    std::vector<std::exception_ptr> errors(num_threads);
+    std::vector<std::thread> threads;
+    auto begin = Clock::now();
+    for (int t = 0; t < num_threads; ++t) {
+        threads.emplace_back([&, t] {
+            try {
+                serve(t, per_thread[t]);
+            } catch (...) {
+                errors[t] = std::current_exception();
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    for (const std::exception_ptr& error : errors) {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+    PhaseResult total;
+    total.seconds = std::chrono::duration<double>(Clock::now() - begin).count();
+    for (const auto& result : per_thread) {
+        total.rows_run += result.rows_run;
+        total.runs += result.runs;
+        total.mismatches += result.mismatches;
+    }
+    return total;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    const char* model_path = "data/linear/linear.onnx";
+    int num_threads = 4;
+    size_t requests_per_thread = 5000;
+    size_t batch_size = 16;
+    size_t distinct = 1000;
+    double skew = 1.0;
+    ResultCacheOptions cache_options;
+
+    try {
+        for (int i = 1; i < argc; ++i) {
+            if (std::strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+                num_threads = std::stoi(argv[++i]);
+            } else if (std::strcmp(argv[i], "--requests") == 0 && i + 1 < argc) {
+                requests_per_thread = std::stoul(argv[++i]);
+            } else if (std::strcmp(argv[i], "--batch") == 0 && i + 1 < argc) {
+                batch_size = std::stoul(argv[++i]);
+            } else if (std::strcmp(argv[i], "--distinct") == 0 && i + 1 < argc) {
+                distinct = std::stoul(argv[++i]);
+            } else if (std::strcmp(argv[i], "--skew") == 0 && i + 1 < argc) {
+                skew = std::stod(argv[++i]);
+            } else if (std::strcmp(argv[i], "--entries") == 0 && i + 1 < argc) {
+                cache_options.max_entries = std::stoul(argv[++i]);
+            } else if (std::strcmp(argv[i], "--cache-mb") == 0 && i + 1 < argc) {
+                cache_options.max_bytes = static_cast<size_t>(std::stod(argv[++i]) * 1024 * 1024);
+            } else if (std::strcmp(argv[i], "--shards") == 0 && i + 1 < argc) {
+                cache_options.shards = std::stoul(argv[++i]);
+            } else if (std::strcmp(argv[i], "--model") == 0 && i + 1 < argc) {
+                model_path = argv[++i];
+            } else {
+                throw std::invalid_argument(argv[i]);
+            }
+        }
+    } catch (const std::exception&) {
+        std::cerr << "Usage: " << argv[0] << " [--threads N] [--requests N] [--batch N] [--distinct N] [--skew S]"
+                  << " [--entries N] [--cache-mb MB] [--shards N] [--model <model_path>]" << std::endl;
+        return EXIT_FAILURE;
+    }
+    if (num_threads <= 0 || requests_per_thread == 0 || batch_size == 0 || distinct == 0 || cache_options.shards == 0) {
+        std::cerr << "Error: --threads, --requests, --batch, --distinct and --shards must be positive." << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    try {
+        Ort::Env env(ORT_LOGGING_LEVEL_WARNING, "linear_cache");
+        Ort::SessionOptions session_options;
+        session_options.SetIntraOpNumThreads(1);
+        Ort::Session session(env, model_path, session_options);
+
+        // --- 1. Generate each thread's requests: value k is picked with weight 1 / (k + 1)^skew ---
+        std::vector<double> weights;
+        for (size_t k = 0; k < distinct; ++k) {
+            weights.push_back(1.0 / std::pow(static_cast<double>(k + 1), skew));
+        }
+        std::discrete_distribution<size_t> pick(weights.begin(), weights.end());
+        std::vector<std::vector<float>> inputs(num_threads);
+        for (int t = 0; t < num_threads; ++t) {
+            std::mt19937 rng(42 + t);
+            inputs[t].resize(requests_per_thread * batch_size);
+            for (float& value : inputs[t]) {
+                value = static_cast<float>(pick(rng)) * 0.5f;
+            }
+        }
+        size_t total_rows = static_cast<size_t>(num_threads) * requests_per_thread * batch_size;
+        std::cout << "Threads: " << num_threads << ", requests: " << requests_per_thread << " per thread, batch: "
+                  << batch_size << ", distinct inputs: " << distinct << ", skew: " << skew << std::endl;
+
+        // --- 2. Without the cache: every row goes to Run; keep the outputs as the reference ---
+        std::vector<std::vector<float>> expected(num_threads);
+        PhaseResult uncached = run_phase(num_threads, [&](int t, PhaseResult& result) {
+            InferenceRunner runner(session);
+            expected[t].resize(inputs[t].size());
+            for (size_t r = 0; r < requests_per_thread; ++r) {
+                Span<const float> input(inputs[t].data() + r * batch_size, batch_size);
+                Span<const float> output = runner.run(input);
+                std::copy(output.begin(), output.end(), expected[t].begin() + r * batch_size);
+                result.rows_run += batch_size;
+                ++result.runs;
+            }
+        });
+
+        // --- 3. With the cache, shared by all threads ---
+        ResultCache cache(cache_options);
+        PhaseResult cached = run_phase(num_threads, [&](int t, PhaseResult& result) {
+            InferenceRunner runner(session);
+            CachedRunner cached_runner(runner, cache);
+            for (size_t r = 0; r < requests_per_thread; ++r) {
+                Span<const float> input(inputs[t].data() + r * batch_size, batch_size);
+                Span<const float> output = cached_runner.run(input);
+                if (!std::equal(output.begin(), output.end(), expected[t].begin() + r * batch_size)) {
+                    ++result.mismatches;
+                }
+                result.rows_run += cached_runner.last_misses();
+                result.runs += cached_runner.last_misses() > 0 ? 1 : 0;
+            }
+        });
+        ResultCacheStats stats = cache.stats();
+
+        // --- 4. Report ---
+        size_t total_requests = static_cast<size_t>(num_threads) * requests_per_thread;
+        std::cout << "\nNo cache:   " << total_requests / uncached.seconds << " req/s, " << uncached.rows_run
+                  << " rows in " << uncached.runs << " Run calls" << std::endl;
+        std::cout << "With cache: " << total_requests / cached.seconds << " req/s, " << cached.rows_run
+                  << " rows in " << cached.runs << " Run calls" << std::endl;
+        std::cout << "\nHit rate: " << stats.hit_rate() * 100.0 << "% (" << stats.hits << " hits, " << stats.misses
+                  << " misses)" << std::endl;
+        std::cout << "Rows computed: " << 100.0 * cached.rows_run / total_rows << "% of " << total_rows
+                  << ", Run calls: " << 100.0 * cached.runs / total_requests << "% of " << total_requests << std::endl;
+        std::cout << "Cache: " << stats.entries << " entries, " << stats.bytes / 1024.0 << " KiB, "
+                  << stats.evictions << " evictions (limits: " << cache_options.max_entries << " entries, "
+                  << cache_options.max_bytes / (1024.0 * 1024.0) << " MiB, " << cache_options.shards << " shards)"
+                  << std::endl;
+        std::cout << "Speedup: " << (cached.seconds > 0.0 ? uncached.seconds / cached.seconds : 0.0) << "x" << std::endl;
+        std::cout << "Outputs differing from the uncached run: " << cached.mismatches << std::endl;
+
+        bool passed = cached.mismatches == 0 && stats.hits + stats.misses == total_rows &&
+                      stats.misses == cached.rows_run;
+        std::cout << "Test " << (passed ? "PASSED" : "FAILED") << std::endl;
+        if (!passed) {
+            return EXIT_FAILURE;
+        }
+
+    } catch (const Ort::Exception& ex) {
+        std::cerr << "ONNX Runtime Error: " << ex.what() << std::endl;
+        return EXIT_FAILURE;
+    } catch (const std::exception& ex) {
+        std::cerr << "Standard C++ Error: " << ex.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,323 @@
+#pragma once
+
+#include <atomic>     // For the generation counter
+#include <chrono>     // For timing the reloads
+#include <condition_variable> // For waking the retiring thread
+#include <cstdint>    // For uint64_t generations
+#include <deque>      // For the models waiting to be retired
+#include <functional> // For the loader and callback
+#include <memory>     // For std::shared_ptr and its atomic load/store
+#include <mutex>      // For serializing reloads
+#include <stdexcept>  // For std::runtime_error
+#include <string>     // For paths and error messages
+#include <thread>     // For the watcher thread
+#include <utility>    // For std::move, std::make_pair
+
+// POSIX/Linux headers for watching the model file
+#include <poll.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#if defined(__linux__)
+#include <sys/inotify.h>
+#endif
+
+// How one reload went.
+struct ReloadStats {
+    uint64_t generation = 0; // Generation now being served.
+    bool ok = false;
+    std::string error;       // Why the new model was rejected (ok == false).
+    double load_ms = 0.0;    // Building and warming up the new model.
+    double swap_us = 0.0;    // Publishing it (the only step requests can overlap with).
+    double retire_ms = 0.0;  // From the swap until the old model's last request ended and it was freed.
+};
+
+// Serves a model (e.g. an Ort::Session) that can be replaced while requests are running.
+//
+// Requests take a reference with current() and run on it; reload() builds and
+// warms up a new model on the calling thread and then publishes it with one
+// atomic shared_ptr store, so requests never wait for a model to load. A
+// request that started on the old model finishes on it: the old model is
+// freed only when the last such request has dropped its reference. That wait
+// and the (possibly slow) destructor run on the reloader's own retiring
+// thread, not on a request thread and not on the thread that reloads, so a
+// long request never delays the next model. If the new model fails to load,
+// the old one keeps serving.
+//
+// watch(path) reloads whenever the file is rewritten or replaced. It uses
+// inotify on the file's directory, so both "cp new.onnx model.onnx" and an
+// atomic "mv new.onnx model.onnx" are picked up; other platforms poll the
+// file's modification time. If the loader memory-maps the file (MappedModel,
+// mapped_model.h), only the rename is safe: cp rewrites the pages the
+// serving model is still reading.
+//
+//   HotReloader<Ort::Session> sessions(load_and_warm_up);
+//   sessions.watch("data/linear/linear.onnx");
+//   std::shared_ptr<Ort::Session> session = sessions.current(); // Per request.
+template <typename Model>
+class HotReloader {
+public:
+    // Builds a ready-to-serve model; it should run the model once so the
+    // first real request does not pay for allocation planning. Throws on failure.
+    using Loader = std::function<std::shared_ptr<Model>()>;
+    using Callback = std::function<void(const ReloadStats&)>;
+
+    // Loads the first model right away; an exception here is the caller's.
+    explicit HotReloader(Loader loader) : loader_(std::move(loader)) {
+        std::shared_ptr<Model> model = loader_();
+        std::atomic_store(&model_, model);
+        generation_ = 1;
+        retirer_ = std::thread(&HotReloader::retire_loop, this);
+    }
+
+    // Models still held by requests at this point are freed by their last request.
+    ~HotReloader() {
+        stop();
+        {
+            std::lock_guard<std::mutex> lock(retire_mutex_);
+            retire_stopping_ = true;
+        }
+        retire_cv_.notify_all();
+        retirer_.join();
+    }
+
+    HotReloader(const HotReloader&) = delete;
+    HotReloader& operator=(const HotReloader&) = delete;
+
+    // The model to use for one request. Hold the pointer for the whole request.
+    std::shared_ptr<Model> current() const { return std::atomic_load(&model_); }
+
+    // Number of models served so far, starting at 1.
+    uint64_t generation() const { return generation_.load(); }
+
+    // Called after every reload attempt: on the reloading thread if it failed,
+    // and on the retiring thread once the replaced model was freed if it
+    // succeeded. A failure can therefore be reported before an earlier success.
+    void on_reload(Callback callback) {
+        std::lock_guard<std::mutex> lock(reload_mutex_);
+        callback_ = std::move(callback);
+    }
+
+    // Loads a new model and swaps it in. Returns false (and keeps the old
+    // model) if loading failed. The old model is handed to the retiring
+    // thread, so this returns as soon as the new model is serving.
+    bool reload() {
+        using Clock = std::chrono::steady_clock;
+        std::lock_guard<std::mutex> lock(reload_mutex_);
+        Retiring retiring;
+        retiring.callback = callback_;
+        ReloadStats& stats = retiring.stats;
+
+        auto begin = Clock::now();
+        std::shared_ptr<Model> fresh;
+        try {
+            fresh = loader_();
+        } catch (const std::exception& ex) {
+            stats.error = ex.what();
+        }
+        stats.load_ms = std::chrono::duration<double, std::milli>(Clock::now() - begin).count();
+        if (!fresh) {
+            if (stats.error.empty()) {
+                stats.error = "loader returned no model";
+            }
+            stats.generation = generation_.load();
+            notify(retiring.callback, stats);
+            return false;
+        }
+
+        begin = Clock::now();
+        retiring.model = std::atomic_exchange(&model_, fresh);
+        stats.generation = ++generation_;
+        retiring.swapped = Clock::now();
+        stats.swap_us = std::chrono::duration<double, std::micro>(retiring.swapped - begin).count();
+        stats.ok = true;
+        fresh.reset();
+        {
+            std::lock_guard<std::mutex> retire_lock(retire_mutex_);
+            retiring_.push_back(std::move(retiring));
+        }
+        retire_cv_.notify_all();
+        return true;
+    }
+
+    // Waits until every model replaced so far has been freed and its reload
+    // reported, e.g. before reading statistics collected by the callback.
+    void wait_retired() {
+        std::unique_lock<std::mutex> lock(retire_mutex_);
+        retire_cv_.wait(lock, [this] { return retiring_.empty() && !retire_busy_; });
+    }
+
+    // Starts a background thread that calls reload() whenever `path` changes.
+    // Changes are debounced for settle_ms so a file being copied in several
+    // writes is loaded once, after the copy finished. Replace a memory-mapped
+    // model only by renaming a new file over it.
+    void watch(const std::string& path, int settle_ms = 100) {
+        stop();
+        if (::pipe(stop_pipe_) != 0) {
+            throw std::runtime_error("cannot create the watcher's stop pipe");
+        }
+        watcher_ = std::thread(&HotReloader::watch_loop, this, path, settle_ms);
+    }
+
+    // Stops the watcher thread, if any. Safe to call more than once.
+    void stop() {
+        if (!watcher_.joinable()) {
+            return;
+        }
+        char byte = 0;
+        ssize_t written = ::write(stop_pipe_[1], &byte, 1);
+        (void)written;
+        watcher_.join();
+        ::close(stop_pipe_[0]);
+        ::close(stop_pipe_[1]);
+    }
+
+private:
+    // A replaced model waiting for its last requests, and the reload that replaced it.
+    struct Retiring {
+        std::shared_ptr<Model> model;
+        ReloadStats stats;
+        Callback callback;
+        std::chrono::steady_clock::time_point swapped;
+    };
+
+    // Body of the retiring thread: frees replaced models in order once no
+    // request holds them any more. When the reloader is destroyed it stops
+    // waiting and leaves each remaining model to its last request.
+    void retire_loop() {
+        std::unique_lock<std::mutex> lock(retire_mutex_);
+        while (true) {
+            retire_cv_.wait(lock, [this] { return retire_stopping_ || !retiring_.empty(); });
+            if (retiring_.empty()) {
+                return;
+            }
+            Retiring retiring = std::move(retiring_.front());
+            retiring_.pop_front();
+            retire_busy_ = true;
+            lock.unlock();
+
+            // Nobody can pick up the old model any more; wait for the requests that already hold it.
+            while (retiring.model.use_count() > 1 && !retire_stopped()) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+            retiring.model.reset();
+            retiring.stats.retire_ms =
+                std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - retiring.swapped).count();
+            notify(retiring.callback, retiring.stats);
+
+            lock.lock();
+            retire_busy_ = false;
+            retire_cv_.notify_all();
+        }
+    }
+
+    bool retire_stopped() {
+        std::lock_guard<std::mutex> lock(retire_mutex_);
+        return retire_stopping_;
+    }
+
+    static void notify(const Callback& callback, const ReloadStats& stats) {
+        if (callback) {
+            callback(stats);
+        }
+    }
+
+    // Waits up to timeout_ms for the stop pipe; returns true if stop() was called.
+    bool wait_for_stop(int timeout_ms) {
+        pollfd fd = {stop_pipe_[0], POLLIN, 0};
+        return ::poll(&fd, 1, timeout_ms) > 0;
+    }
+
+#if defined(__linux__)
+    void watch_loop(std::string path, int settle_ms) {
+        size_t slash = path.rfind('/');
+        std::string directory = slash == std::string::npos ? "." : path.substr(0, slash == 0 ? 1 : slash);
+        std::string file_name = slash == std::string::npos ? path : path.substr(slash + 1);
+
+        int inotify_fd = ::inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if (inotify_fd < 0 || ::inotify_add_watch(inotify_fd, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO) < 0) {
+            if (inotify_fd >= 0) {
+                ::close(inotify_fd);
+            }
+            poll_loop(path, settle_ms); // No inotify (e.g. out of watches): fall back to polling.
+            return;
+        }
+
+        alignas(inotify_event) char buffer[4096];
+        pollfd fds[2] = {{stop_pipe_[0], POLLIN, 0}, {inotify_fd, POLLIN, 0}};
+        bool changed = false;
+        while (true) {
+            // Block until an event, or, once the file changed, until it has been quiet for settle_ms.
+            int ready = ::poll(fds, 2, changed ? settle_ms : -1);
+            if (ready < 0) {
+                continue; // EINTR
+            }
+            if (fds[0].revents != 0) {
+                break;
+            }
+            if (ready == 0) {
+                changed = false;
+                reload();
+                continue;
+            }
+            ssize_t length;
+            while ((length = ::read(inotify_fd, buffer, sizeof(buffer))) > 0) {
+                for (char* p = buffer; p < buffer + length;) {
+                    const inotify_event* event = reinterpret_cast<const inotify_event*>(p);
+                    if (event->len > 0 && file_name == event->name) {
+                        changed = true;
+                    }
+                    p += sizeof(inotify_event) + event->len;
+                }
+            }
+        }
+        ::close(inotify_fd);
+    }
+#else
+    void watch_loop(std::string path, int settle_ms) {
+        poll_loop(path, settle_ms);
+    }
+#endif
+
+    // Checks the file's modification time and size every settle_ms.
+    void poll_loop(const std::string& path, int settle_ms) {
+        auto stamp = [&path] {
+            struct stat info;
+            if (::stat(path.c_str(), &info) != 0) {
+                return std::make_pair(static_cast<long long>(-1), static_cast<long long>(-1));
+            }
+            return std::make_pair(static_cast<long long>(info.st_mtime), static_cast<long long>(info.st_size));
+        };
+        auto last = stamp();
+        while (!wait_for_stop(settle_ms)) {
+            auto now = stamp();
+            if (now == last || now.first == -1) {
+                continue;
+            }
+            // Changed: wait until it stops changing, then load it once.
+            do {
+                last = now;
+                if (wait_for_stop(settle_ms)) {
+                    return;
+                }
+                now = stamp();
+            } while (now != last);
+            reload();
+        }
+    }
+
+    Loader loader_;
+    std::shared_ptr<Model> model_; // Only accessed through std::atomic_load/store/exchange.
+    std::atomic<uint64_t> generation_{0};
+    std::mutex reload_mutex_;      // One reload at a time (watcher or manual).
+    Callback callback_;
+
+    std::thread watcher_;
+    int stop_pipe_[2] = {-1, -1};
+
+    std::mutex retire_mutex_;      // Protects retiring_, retire_busy_ and retire_stopping_.
+    std::condition_variable retire_cv_;
+    std::deque<Retiring> retiring_;
+    bool retire_busy_ = false;     // The retiring thread is working on a model taken off retiring_.
+    bool retire_stopping_ = false;
+    std::thread retirer_;
+};
@@ -0,0 +1,186 @@
+#include <iostream> // For standard input/output operations (e.g., std::cout, std::cerr)
+#include <vector>   // For std::vector in the classic path
+#include <string>   // For std::string to handle argument parsing
+#include <cstdlib>  // For std::malloc/std::free and EXIT_FAILURE/EXIT_SUCCESS
+#include <cstring>  // For std::strcmp
+#include <chrono>   // For timing the runs
+#include <atomic>   // For the allocation counter
+#include <new>      // For replacing the global operator new/delete
+#include <cmath>    // For std::round
+
+// ONNX Runtime C++ API header file
+#include <onnxruntime_cxx_api.h>
+
+#include "io_binding_runner.h"
+#include "latency_stats.h"
+
+// Compares the classic CreateTensor + Run + copy path of main2.cpp against
+// IoBindingRunner, counting operator new allocations made during the timed loop.
+//
+//   ./linear_iobinding --batch 256 --iterations 10000
+
+// --- Allocation counter ---
+// Only operator new is counted. Replacing the global operator new/delete in
+// the executable also catches the `new` calls made inside libonnxruntime,
+// since the dynamic linker resolves them to these definitions, but ORT's CPU
+// allocator and arena get their buffers from malloc/posix_memalign directly,
+// which this does not see. "0 per run" therefore means no C++ object
+// allocations, not that ORT's arena never grew. The array and nothrow forms
+// fall back to these by default.
+namespace {
+std::atomic<size_t> g_allocation_count{0};
+}
+
+void* operator new(std::size_t size) {
+    g_allocation_count.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size == 0 ? 1 : size)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    g_allocation_count.fetch_add(1, std::memory_order_relaxed);
+    size_t align = static_cast<size_t>(alignment);
+    size_t bytes = (size + align - 1) / align * align;
+    if (void* p = std::aligned_alloc(align, bytes == 0 ? align : bytes)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::align_val_t) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept {
+    std::free(p);
+}
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct LoopResult {
+    LatencyStats latency;
+    size_t allocations = 0;
+    double wall_seconds = 0.0;
+};
+
+// Times `iterations` calls of step() after `warmup` untimed calls.
+template <typename StepFn>
+LoopResult measure(int warmup, int iterations, StepFn step) {
+    for (int i = 0; i < warmup; ++i) {
+        step();
+    }
+    LoopResult result;
+    result.latency.reserve(iterations); // Reserve before counting starts.
+    size_t allocations_before = g_allocation_count.load();
+    auto begin = Clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        auto step_begin = Clock::now();
+        step();
+        result.latency.add(std::chrono::duration<double, std::micro>(Clock::now() - step_begin).count());
+    }
+    result.wall_seconds = std::chrono::duration<double>(Clock::now() - begin).count();
+    result.allocations = g_allocation_count.load() - allocations_before;
+    return result;
+}
+
+void print_result(const char* title, const LoopResult& result, int iterations) {
+    std::cout << "\n--- " << title << " ---" << std::endl;
+    result.latency.print(std::cout, result.wall_seconds);
+    std::cout << "operator new calls: " << result.allocations
+              << " (" << static_cast<double>(result.allocations) / iterations << " per run)" << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    const char* model_path = "data/linear/linear.onnx";
+    size_t batch_size = 256;
+    int iterations = 10000;
+    int warmup = 100;
+
+    try {
+        for (int i = 1; i < argc; ++i) {
+            if (std::strcmp(argv[i], "--batch") == 0 && i + 1 < argc) {
+                batch_size = std::stoul(argv[++i]);
+            } else if (std::strcmp(argv[i], "--iterations") == 0 && i + 1 < argc) {
+                iterations = std::stoi(argv[++i]);
+            } else if (std::strcmp(argv[i], "--model") == 0 && i + 1 < argc) {
+                model_path = argv[++i];
+            } else {
+                throw std::invalid_argument(argv[i]);
+            }
+        }
+    } catch (const std::exception&) {
+        std::cerr << "Usage: " << argv[0] << " [--batch N] [--iterations N] [--model <model_path>]" << std::endl;
+        return EXIT_FAILURE;
+    }
+    if (batch_size == 0 || iterations <= 0) {
+        std::cerr << "Error: --batch and --iterations must be positive." << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    try {
+        Ort::Env env(ORT_LOGGING_LEVEL_WARNING, "linear_iobinding");
+        Ort::Session session(env, model_path, Ort::SessionOptions());
+        std::cout << "Batch size: " << batch_size << ", iterations: " << iterations << std::endl;
+
+        // --- 1. Classic path: new input vector, Run allocates outputs, copy into a vector ---
+        auto memory_info = Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
+        std::vector<int64_t> input_shape = {static_cast<int64_t>(batch_size), 1};
+        const char* input_name = "input";
+        const char* output_name = "output";
+        float checksum_classic = 0.0f;
+        LoopResult classic = measure(warmup, iterations, [&] {
+            std::vector<float> input_data(batch_size, 1.0f);
+            Ort::Value input_tensor = Ort::Value::CreateTensor<float>(
+                memory_info, input_data.data(), input_data.size(),
+                input_shape.data(), input_shape.size());
+            auto output_tensors = session.Run(Ort::RunOptions{nullptr},
+                                              &input_name, &input_tensor, 1,
+                                              &output_name, 1);
+            float* output_data_ptr = output_tensors[0].GetTensorMutableData<float>();
+            std::vector<float> output_data(output_data_ptr, output_data_ptr + batch_size);
+            checksum_classic = output_data[0];
+        });
+        print_result("CreateTensor + Run + copy", classic, iterations);
+
+        // --- 2. IoBinding with buffers bound once and reused ---
+        IoBindingRunner runner(session);
+        float* input_data = runner.input(batch_size);
+        for (size_t i = 0; i < batch_size; ++i) {
+            input_data[i] = 1.0f;
+        }
+        float checksum_bound = 0.0f;
+        LoopResult bound = measure(warmup, iterations, [&] {
+            checksum_bound = runner.run(batch_size)[0];
+        });
+        print_result("IoBinding with reused buffers", bound, iterations);
+
+        bool passed = std::round(checksum_classic) == 2 && std::round(checksum_bound) == 2;
+        std::cout << "\nTest " << (passed ? "PASSED" : "FAILED") << std::endl;
+        if (!passed) {
+            return EXIT_FAILURE;
+        }
+
+    } catch (const Ort::Exception& ex) {
+        std::cerr << "ONNX Runtime Error: " << ex.what() << std::endl;
+        return EXIT_FAILURE;
+    } catch (const std::exception& ex) {
+        std::cerr << "Standard C++ Error: " << ex.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
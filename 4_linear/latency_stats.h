@@ -0,0 +1,75 @@
+#pragma once
+
+#include <algorithm> // For std::sort
+#include <cstddef>   // For size_t
+#include <ostream>   // For std::ostream
+#include <vector>    // For std::vector to hold the samples
+
+// Collects per-request latencies (in microseconds) and summarizes them.
+// Samples are kept as-is and only sorted when a summary is requested,
+// so recording a sample is just a push_back on the hot path.
+class LatencyStats {
+public:
+    void reserve(size_t n) { samples_us_.reserve(n); }
+
+    void add(double latency_us) {
+        samples_us_.push_back(latency_us);
+        sorted_valid_ = false;
+    }
+
+    void clear() {
+        samples_us_.clear();
+        sorted_valid_ = false;
+    }
+
+    size_t count() const { return samples_us_.size(); }
+
+    const std::vector<double>& samples() const { return samples_us_; }
+
+    // Returns the p-th percentile (0..100) using the nearest-rank method.
+    // Returns 0 when no samples have been recorded.
+    double percentile(double p) const {
+        if (samples_us_.empty()) {
+            return 0.0;
+        }
+        sort_if_needed();
+        size_t rank = static_cast<size_t>(p / 100.0 * (sorted_.size() - 1) + 0.5);
+        return sorted_[std::min(rank, sorted_.size() - 1)];
+    }
+
+    double mean() const {
+        if (samples_us_.empty()) {
+            return 0.0;
+        }
+        double sum = 0.0;
+        for (double s : samples_us_) {
+            sum += s;
+        }
+        return sum / samples_us_.size();
+    }
+
+    // Prints count, mean, p50, p99 and throughput in a human readable form.
+    // wall_seconds is the time over which the samples were collected.
+    void print(std::ostream& os, double wall_seconds) const {
+        os << "Requests: " << count() << std::endl;
+        os << "Latency mean: " << mean() << " us" << std::endl;
+        os << "Latency p50: " << percentile(50) << " us" << std::endl;
+        os << "Latency p99: " << percentile(99) << " us" << std::endl;
+        if (wall_seconds > 0.0) {
+            os << "Throughput: " << count() / wall_seconds << " req/s" << std::endl;
+        }
+    }
+
+private:
+    void sort_if_needed() const {
+        if (!sorted_valid_) {
+            sorted_ = samples_us_;
+            std::sort(sorted_.begin(), sorted_.end());
+            sorted_valid_ = true;
+        }
+    }
+
+    std::vector<double> samples_us_;
+    mutable std::vector<double> sorted_;
+    mutable bool sorted_valid_ = false;
+};
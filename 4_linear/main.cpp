@@ -8,6 +8,8 @@
 // ONNX Runtime C++ API header file
 #include <onnxruntime_cxx_api.h>
 
+#include "inference_runner.h"
+
 int main(int argc, char* argv[]) {
     if (argc != 2) {
         std::cerr << "Usage: " << argv[0] << " <input_number>" << std::endl;
@@ -16,25 +18,13 @@ int main(int argc, char* argv[]) {
 
     try {
         float input_value = std::stof(argv[1]);
-        std::vector<float> input_data = {input_value};
-        std::vector<int64_t> input_shape = {1, 1};
 
+        // The runner reads the input/output names and shapes from the model,
+        // so the [1, 1] shape and the "input"/"output" names are not hard-coded.
         Ort::Env env(ORT_LOGGING_LEVEL_WARNING, "linear_inference");
-        Ort::Session session(env, "data/linear/linear.onnx", Ort::SessionOptions());
-
-        auto memory_info = Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
-        Ort::Value input_tensor = Ort::Value::CreateTensor<float>(
-            memory_info, input_data.data(), input_data.size(),
-            input_shape.data(), input_shape.size());
-
-        const char* input_name = "input";
-        const char* output_name = "output";
-        auto output_tensors = session.Run(
-            Ort::RunOptions{nullptr},
-            &input_name, &input_tensor, 1,
-            &output_name, 1);
+        InferenceRunner runner(env, "data/linear/linear.onnx");
 
-        float* output_data = output_tensors[0].GetTensorMutableData<float>();
+        Span<const float> output_data = runner.run(Span<const float>(&input_value, 1));
         int rounded_output = std::round(output_data[0]);
         int expected_output = std::round(input_value * 2.0f);
 
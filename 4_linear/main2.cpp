@@ -8,6 +8,10 @@
 // ONNX Runtime C++ API header file
 #include <onnxruntime_cxx_api.h>
 
+#include "inference_runner.h"
+#include "metrics.h"
+#include "tensor_info.h"
+
 int main(int argc, char* argv[]) {
     // Check if the correct number of command-line arguments is provided.
     // argc should be 2: 1 for the program name itself, 1 for the input number.
@@ -39,6 +43,9 @@ int main(int argc, char* argv[]) {
     // Initialize the ONNX Runtime environment.
     // ORT_LOGGING_LEVEL_WARNING suppresses verbose logs, showing only warnings and errors.
     Ort::Env env(ORT_LOGGING_LEVEL_WARNING, "linear_inference_session");
+    // The stage timings printed at the end come from Metrics, which records nothing until enabled.
+    Metrics::global().set_enabled(true);
+
     // Create session options. Default options are used here.
     Ort::SessionOptions session_options;
 
@@ -48,92 +55,49 @@ int main(int argc, char* argv[]) {
 
     try {
         // Create an ONNX Runtime session by loading the model.
-        Ort::Session session(env, model_path, session_options);
+        // InferenceRunner owns the session and reads the model's input/output
+        // names, types and shapes once, right after loading it.
+        InferenceRunner runner(env, model_path, session_options);
         std::cout << "Model loaded successfully from: " << model_path << std::endl;
 
         // --- 2. Prepare Input Data ---
-        // Get the memory allocator, used for managing memory when working with ORT objects.
-        Ort::AllocatorWithDefaultOptions allocator;
-
-        // Store the Ort::AllocatedStringPtrs to manage their lifetime,
-        // then get the const char* for session.Run().
-        // This robust pattern ensures the string pointers remain valid.
-        std::vector<Ort::AllocatedStringPtr> input_name_ptrs;
-        std::vector<const char*> input_names_c_str;
-        for (size_t i = 0; i < session.GetInputCount(); ++i) {
-            input_name_ptrs.push_back(session.GetInputNameAllocated(i, allocator));
-            input_names_c_str.push_back(input_name_ptrs.back().get());
-        }
-
-        std::vector<Ort::AllocatedStringPtr> output_name_ptrs;
-        std::vector<const char*> output_names_c_str;
-        for (size_t i = 0; i < session.GetOutputCount(); ++i) {
-            output_name_ptrs.push_back(session.GetOutputNameAllocated(i, allocator));
-            output_names_c_str.push_back(output_name_ptrs.back().get());
-        }
-
-        // Define the input shape for the model.
-        // Our linear model expects a single float, so its shape is [1, 1] (Batch size 1, 1 feature).
-        std::vector<int64_t> input_shape = {1, 1};
+        // The names come from the model itself instead of being hard-coded, and the
+        // runner keeps them (and the const char* arrays Session::Run needs) alive.
+        std::cout << "Model input: '" << runner.inputs()[0].name << "' "
+                  << shape_to_string(runner.inputs()[0].shape) << ", output: '"
+                  << runner.outputs()[0].name << "' " << shape_to_string(runner.outputs()[0].shape) << std::endl;
 
         // Create a standard C++ vector to hold the input data, using the parsed command-line value.
+        // Our linear model expects [batch_size, 1]; the runner sets the dynamic batch
+        // dimension from the number of values, so one value gives the shape [1, 1].
         std::vector<float> input_data = {input_value};
-        size_t total_input_elements = input_data.size(); // Total elements in the input tensor.
-
-        // Create memory info for CPU-based tensor creation.
-        // This tells ONNX Runtime that the tensor data resides in CPU memory.
-        auto memory_info = Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
-
-        // Create the ONNX Runtime input tensor (Ort::Value) from our C++ vector.
-        Ort::Value input_tensor = Ort::Value::CreateTensor<float>(
-            memory_info,            // Memory allocation information
-            input_data.data(),      // Raw pointer to the C++ vector's data
-            total_input_elements,   // Total number of elements
-            input_shape.data(),     // Pointer to the tensor's shape array
-            input_shape.size()      // Length of the shape array
-        );
-
-        // Ensure the input tensor is valid (optional, good for debugging).
-        if (!input_tensor.IsTensor()) {
-            std::cerr << "Error: Created input tensor is not valid!" << std::endl;
-            return EXIT_FAILURE;
-        }
-
         std::cout << "Input data prepared: " << input_data[0] << std::endl;
-        std::cout << "Input tensor shape: [" << input_shape[0] << ", " << input_shape[1] << "]" << std::endl;
 
         // --- 3. Execute Model Inference ---
         std::cout << "Running inference..." << std::endl;
 
         // Run the inference! This is the core step.
-        // It takes input tensors and returns output tensors.
-        std::vector<Ort::Value> output_tensors = session.Run(
-            Ort::RunOptions{nullptr}, // No special run options for this example
-            input_names_c_str.data(), // Array of input names (C-style strings)
-            &input_tensor,            // Array of input tensors (address of our single input tensor)
-            1,                        // Number of input tensors
-            output_names_c_str.data(),// Array of output names (C-style strings)
-            1                         // Number of output tensors
-        );
+        // The runner wraps input_data in an input tensor (no copy), runs the session,
+        // and returns a view of the output values in a buffer it reuses across runs.
+        Span<const float> output_values = runner.run(input_data);
 
         std::cout << "Inference completed." << std::endl;
 
         // --- 4. Process Output Data ---
-        // Check if output tensors are valid and not empty.
-        if (output_tensors.empty() || !output_tensors[0].IsTensor()) {
-            std::cerr << "Error: No valid output tensors received!" << std::endl;
+        // Check that the output is not empty.
+        if (output_values.empty()) {
+            std::cerr << "Error: No output values received!" << std::endl;
             return EXIT_FAILURE;
         }
 
-        // Get a pointer to the raw data of the first output tensor.
-        // We expect float values from our linear model.
-        float* output_data_ptr = output_tensors[0].GetTensorMutableData<float>();
-
-        // Get the total number of elements in the output tensor.
-        size_t total_output_elements = output_tensors[0].GetTensorTypeAndShapeInfo().GetElementCount();
-
-        // Copy the output data from the ORT tensor into a standard C++ vector.
-        std::vector<float> output_data(output_data_ptr, output_data_ptr + total_output_elements);
+        // Copy the output data from the runner's buffer into a standard C++ vector.
+        // The copy is timed into the same histogram the runner uses for output conversion.
+        std::vector<float> output_data;
+        {
+            ScopedTimer timer(Metrics::global().histogram("inference_runner_output_copy_seconds",
+                                                          "Time to copy or convert the output to float"));
+            output_data.assign(output_values.begin(), output_values.end());
+        }
 
         std::cout << "Inferred output: " << output_data[0] << std::endl; // For our simple model, there's only one element
 
@@ -152,6 +116,17 @@ int main(int argc, char* argv[]) {
             std::cout << "Inference result MISMATCHES expected value after rounding. Test FAILED!" << std::endl;
         }
 
+        // --- 5. Where the time went ---
+        // The runner recorded each stage into Metrics::global(); print the mean of each.
+        const char* stages[] = {"session_create", "tensor_create", "run", "output_copy"};
+        std::cout << "Stage timings:";
+        for (const char* stage : stages) {
+            std::string name = std::string("inference_runner_") + stage + "_seconds";
+            HistogramSnapshot snapshot = Metrics::global().histogram(name, "").snapshot();
+            std::cout << " " << stage << " " << snapshot.mean_ns() / 1000.0 << " us;";
+        }
+        std::cout << std::endl;
+
     } catch (const Ort::Exception& ex) {
         // Catch any ONNX Runtime-specific exceptions for robust error handling.
         std::cerr << "ONNX Runtime Error: " << ex.what() << std::endl;
@@ -2,12 +2,17 @@
 #include <vector>   // For std::vector to hold input/output data
 #include <string>   // For std::string to handle names and argument parsing
 #include <numeric>  // Not strictly needed for this example but good practice
-#include <cstdlib>  // For std::stof (string to float) and EXIT_FAILURE/EXIT_SUCCESS
+#include <cstdlib>  // For EXIT_FAILURE/EXIT_SUCCESS
+#include <cstring>  // For std::strlen
+#include <stdexcept> // For std::invalid_argument
 #include <cmath>    // For std::abs
 
 // ONNX Runtime C++ API header file
 #include <onnxruntime_cxx_api.h>
 
+#include "inference_runner.h"
+#include "simd_prepost.h"
+
 int main(int argc, char* argv[]) {
     if (argc < 2 || argc > 6) {
         std::cerr << "Usage: " << argv[0] << " <input_number1> [input_number2] [input_number3] [input_number4] [input_number5]" << std::endl;
@@ -22,40 +27,35 @@ int main(int argc, char* argv[]) {
 
         // Parse input values
         for (int i = 1; i < argc; i++) {
-            input_data.push_back(std::stof(argv[i]));
+            float value;
+            if (!parse_float(argv[i], argv[i] + std::strlen(argv[i]), &value)) {
+                throw std::invalid_argument(std::string("not a number: ") + argv[i]);
+            }
+            input_data.push_back(value);
         }
 
-        // Set input shape [batch_size, 1]
-        std::vector<int64_t> input_shape = {static_cast<int64_t>(num_inputs), 1};
-
+        // The runner sets the dynamic batch dimension from the input size: [num_inputs, 1]
         Ort::Env env(ORT_LOGGING_LEVEL_WARNING, "linear_inference");
-        Ort::Session session(env, "data/linear/linear.onnx", Ort::SessionOptions());
-
-        auto memory_info = Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
-        Ort::Value input_tensor = Ort::Value::CreateTensor<float>(
-            memory_info, input_data.data(), input_data.size(),
-            input_shape.data(), input_shape.size());
+        InferenceRunner runner(env, "data/linear/linear.onnx");
 
-        const char* input_name = "input";
-        const char* output_name = "output";
-        auto output_tensors = session.Run(
-            Ort::RunOptions{nullptr},
-            &input_name, &input_tensor, 1,
-            &output_name, 1);
+        Span<const float> output_data = runner.run(input_data);
 
-        float* output_data = output_tensors[0].GetTensorMutableData<float>();
+        // Check every output against 2 * input in one pass (same +-0.5 slack as rounding)
+        ToleranceCheck check = check_scaled(input_data.data(), output_data.data(), num_inputs, 2.0f, 0.5f);
 
-        // Process and display results for each input
+        // Process and display results for each input; '\n' instead of std::endl avoids a flush per line
         for (size_t i = 0; i < num_inputs; i++) {
             int rounded_output = std::round(output_data[i]);
             int expected_output = std::round(input_data[i] * 2.0f);
 
-            std::cout << "Input " << (i + 1) << ": " << input_data[i] << std::endl;
-            std::cout << "Output " << (i + 1) << ": " << output_data[i] << std::endl;
-            std::cout << "Expected " << (i + 1) << ": " << expected_output << std::endl;
-            std::cout << "Test " << (i + 1) << " " << (rounded_output == expected_output ? "PASSED" : "FAILED") << std::endl;
-            std::cout << "-------------------" << std::endl;
+            std::cout << "Input " << (i + 1) << ": " << input_data[i] << '\n';
+            std::cout << "Output " << (i + 1) << ": " << output_data[i] << '\n';
+            std::cout << "Expected " << (i + 1) << ": " << expected_output << '\n';
+            std::cout << "Test " << (i + 1) << " " << (rounded_output == expected_output ? "PASSED" : "FAILED") << '\n';
+            std::cout << "-------------------" << '\n';
         }
+        std::cout << "Max abs error: " << check.max_abs_error << ", failures: " << check.failures
+                  << " of " << check.count << std::endl;
 
     } catch (const std::exception& e) {
         std::cerr << "Error: " << e.what() << std::endl;
@@ -0,0 +1,175 @@
+#include <iostream> // For standard input/output operations (e.g., std::cout, std::cerr)
+#include <vector>   // For std::vector to hold request data
+#include <string>   // For std::string to handle argument parsing
+#include <cstdlib>  // For EXIT_FAILURE/EXIT_SUCCESS
+#include <cstring>  // For std::strcmp
+#include <chrono>   // For the run duration
+#include <thread>   // For the load threads
+#include <atomic>   // For the stop flag
+#include <cmath>    // For std::round
+#include <algorithm> // For std::max
+#include <stdexcept> // For std::invalid_argument
+
+// ONNX Runtime C++ API header file
+#include <onnxruntime_cxx_api.h>
+
+#include "inference_runner.h"
+#include "metrics.h"
+
+// Runs the linear model under load with the metrics layer off and then on.
+//
+// Every thread drives its own InferenceRunner over one shared session, which
+// times tensor creation, Run and output handling into Metrics::global(). The
+// second phase also dumps the metrics to a Prometheus text file every
+// --interval-ms, the way a long-running server would. Comparing the two
+// phases' throughput shows what the instrumentation costs.
+//
+//   ./linear_metrics --threads 4 --seconds 2
+//   ./linear_metrics --metrics-file /var/lib/node_exporter/linear.prom --interval-ms 5000
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct PhaseResult {
+    size_t requests = 0;
+    size_t failures = 0;
+    double seconds = 0.0;
+    double rate() const { return seconds > 0.0 ? requests / seconds : 0.0; }
+};
+
+// num_threads threads call runner.run back to back for `seconds`.
+PhaseResult run_phase(Ort::Session& session, int num_threads, double seconds, size_t batch_size) {
+    std::atomic<bool> stop{false};
+    std::vector<size_t> requests(num_threads, 0);
+    std::vector<size_t> failures(num_threads, 0);
+    std::vector<std::thread> threads;
+    auto begin = Clock::now();
+    for (int t = 0; t < num_threads; ++t) {
+        threads.emplace_back([&, t] {
+            InferenceRunner runner(session);
+            std::vector<float> input(batch_size);
+            for (size_t r = 0; !stop.load(std::memory_order_relaxed); ++r) {
+                for (size_t i = 0; i < batch_size; ++i) {
+                    input[i] = static_cast<float>((r + i) % 100);
+                }
+                Span<const float> output = runner.run(input);
+                if (output.size() != batch_size || std::round(output[batch_size - 1]) != std::round(input.back() * 2.0f)) {
+                    ++failures[t];
+                }
+                ++requests[t];
+            }
+        });
+    }
+    std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+    stop = true;
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    PhaseResult result;
+    result.seconds = std::chrono::duration<double>(Clock::now() - begin).count();
+    for (int t = 0; t < num_threads; ++t) {
+        result.requests += requests[t];
+        result.failures += failures[t];
+    }
+    return result;
+}
+
+void print_stage(const char* stage) {
+    std::string name = std::string("inference_runner_") + stage + "_seconds";
+    HistogramSnapshot snapshot = Metrics::global().histogram(name, "").snapshot();
+    std::cout << "  " << stage << ": count " << snapshot.count << ", mean " << snapshot.mean_ns() / 1000.0
+              << " us, p50 " << snapshot.percentile_ns(50) / 1000.0 << " us, p99 "
+              << snapshot.percentile_ns(99) / 1000.0 << " us" << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    const char* model_path = "data/linear/linear.onnx";
+    std::string metrics_path = "linear_metrics.prom";
+    int num_threads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    double seconds = 2.0;
+    size_t batch_size = 16;
+    int interval_ms = 1000;
+
+    try {
+        for (int i = 1; i < argc; ++i) {
+            if (std::strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+                num_threads = std::stoi(argv[++i]);
+            } else if (std::strcmp(argv[i], "--seconds") == 0 && i + 1 < argc) {
+                seconds = std::stod(argv[++i]);
+            } else if (std::strcmp(argv[i], "--batch") == 0 && i + 1 < argc) {
+                batch_size = std::stoul(argv[++i]);
+            } else if (std::strcmp(argv[i], "--metrics-file") == 0 && i + 1 < argc) {
+                metrics_path = argv[++i];
+            } else if (std::strcmp(argv[i], "--interval-ms") == 0 && i + 1 < argc) {
+                interval_ms = std::stoi(argv[++i]);
+            } else if (std::strcmp(argv[i], "--model") == 0 && i + 1 < argc) {
+                model_path = argv[++i];
+            } else {
+                throw std::invalid_argument(argv[i]);
+            }
+        }
+    } catch (const std::exception&) {
+        std::cerr << "Usage: " << argv[0] << " [--threads N] [--seconds S] [--batch N] [--metrics-file <file>]"
+                  << " [--interval-ms N] [--model <model_path>]" << std::endl;
+        return EXIT_FAILURE;
+    }
+    if (num_threads <= 0 || seconds <= 0.0 || batch_size == 0 || interval_ms <= 0) {
+        std::cerr << "Error: --threads, --seconds, --batch and --interval-ms must be positive." << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    try {
+        Ort::Env env(ORT_LOGGING_LEVEL_WARNING, "linear_metrics");
+        Ort::SessionOptions session_options;
+        session_options.SetIntraOpNumThreads(1);
+        Ort::Session session(env, model_path, session_options);
+
+        std::cout << "Threads: " << num_threads << ", batch: " << batch_size << ", "
+                  << seconds << " s per phase" << std::endl;
+
+        // --- 1. Metrics off ---
+        Metrics::global().set_enabled(false);
+        PhaseResult off = run_phase(session, num_threads, seconds, batch_size);
+
+        // --- 2. Metrics on, with a periodic dump file ---
+        Metrics::global().set_enabled(true);
+        MetricCounter runs = Metrics::global().counter("inference_runner_runs_total", "Completed InferenceRunner runs");
+        uint64_t runs_before = runs.value();
+        PhaseResult on;
+        {
+            MetricsDumper dumper(metrics_path, interval_ms);
+            on = run_phase(session, num_threads, seconds, batch_size);
+        } // The dumper writes the file one last time when it stops.
+        uint64_t runs_recorded = runs.value() - runs_before;
+
+        std::cout << "\nMetrics off: " << off.rate() << " req/s" << std::endl;
+        std::cout << "Metrics on:  " << on.rate() << " req/s" << std::endl;
+        std::cout << "Overhead: " << (off.rate() > 0.0 ? (1.0 - on.rate() / off.rate()) * 100.0 : 0.0) << "%" << std::endl;
+        std::cout << "\nStages (metrics on):" << std::endl;
+        print_stage("tensor_create");
+        print_stage("run");
+        std::cout << "Runs recorded: " << runs_recorded << " of " << on.requests
+                  << ", written to " << metrics_path << std::endl;
+
+        std::cout << "\n--- " << metrics_path << " ---\n" << Metrics::global().render_prometheus();
+
+        bool passed = off.failures == 0 && on.failures == 0 && runs_recorded == on.requests;
+        std::cout << "Test " << (passed ? "PASSED" : "FAILED") << std::endl;
+        if (!passed) {
+            return EXIT_FAILURE;
+        }
+
+    } catch (const Ort::Exception& ex) {
+        std::cerr << "ONNX Runtime Error: " << ex.what() << std::endl;
+        return EXIT_FAILURE;
+    } catch (const std::exception& ex) {
+        std::cerr << "Standard C++ Error: " << ex.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
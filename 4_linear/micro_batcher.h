@@ -0,0 +1,165 @@
+#pragma once
+
+#include <algorithm>          // For std::min
+#include <atomic>             // For the batch counters
+#include <chrono>             // For the max wait time
+#include <condition_variable> // For waking the worker thread
+#include <cstdint>            // For int64_t shapes
+#include <deque>              // For the request queue
+#include <future>             // For std::promise/std::future results
+#include <mutex>              // For protecting the queue
+#include <thread>             // For the worker thread
+#include <vector>             // For the batched input/output buffers
+
+// ONNX Runtime C++ API header file
+#include <onnxruntime_cxx_api.h>
+
+// Coalesces single-value requests from many threads into one [N, 1] Run.
+//
+// linear.onnx has a dynamic batch axis, so N requests can be answered by one
+// session.Run on an [N, 1] tensor instead of N separate runs. Callers submit()
+// a value and get a std::future back. A worker thread flushes the queue as one
+// batch as soon as max_batch_size requests are waiting, or when the oldest
+// request has waited max_wait, whichever happens first.
+class MicroBatcher {
+public:
+    struct Options {
+        size_t max_batch_size = 64;
+        std::chrono::microseconds max_wait{500};
+    };
+
+    // The session must outlive the batcher.
+    MicroBatcher(Ort::Session& session, Options options)
+        : session_(session),
+          options_(options),
+          memory_info_(Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault)) {
+        batch_.reserve(options_.max_batch_size);
+        input_data_.reserve(options_.max_batch_size);
+        output_data_.reserve(options_.max_batch_size);
+        worker_ = std::thread(&MicroBatcher::worker_loop, this);
+    }
+
+    // Drains the requests that are already queued, then stops the worker.
+    ~MicroBatcher() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        cv_.notify_one();
+        worker_.join();
+    }
+
+    MicroBatcher(const MicroBatcher&) = delete;
+    MicroBatcher& operator=(const MicroBatcher&) = delete;
+
+    std::future<float> submit(float value) {
+        Request request{value, std::promise<float>(), Clock::now()};
+        std::future<float> result = request.result.get_future();
+        bool notify;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            queue_.push_back(std::move(request));
+            // The worker only needs a wake-up when the queue becomes non-empty
+            // (to start the wait timer) or when a full batch is ready.
+            notify = queue_.size() == 1 || queue_.size() >= options_.max_batch_size;
+        }
+        if (notify) {
+            cv_.notify_one();
+        }
+        return result;
+    }
+
+    // Number of Run calls and requests served so far, for reporting the average batch size.
+    size_t batches_run() const { return batches_run_; }
+    size_t requests_served() const { return requests_served_; }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Request {
+        float value;
+        std::promise<float> result;
+        Clock::time_point enqueued;
+    };
+
+    void worker_loop() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (true) {
+            cv_.wait(lock, [this] { return stopping_ || !queue_.empty(); });
+            if (queue_.empty()) {
+                return; // Stopping and nothing left to serve.
+            }
+
+            // Give the batch until the oldest request's deadline to fill up.
+            Clock::time_point deadline = queue_.front().enqueued + options_.max_wait;
+            cv_.wait_until(lock, deadline, [this] {
+                return stopping_ || queue_.size() >= options_.max_batch_size;
+            });
+
+            size_t count = std::min(queue_.size(), options_.max_batch_size);
+            for (size_t i = 0; i < count; ++i) {
+                batch_.push_back(std::move(queue_.front()));
+                queue_.pop_front();
+            }
+
+            // Run without holding the lock so clients can keep queueing.
+            lock.unlock();
+            run_batch();
+            lock.lock();
+        }
+    }
+
+    void run_batch() {
+        const size_t count = batch_.size();
+        input_data_.resize(count);
+        output_data_.resize(count);
+        for (size_t i = 0; i < count; ++i) {
+            input_data_[i] = batch_[i].value;
+        }
+
+        try {
+            int64_t shape[2] = {static_cast<int64_t>(count), 1};
+            Ort::Value input_tensor = Ort::Value::CreateTensor<float>(
+                memory_info_, input_data_.data(), count, shape, 2);
+            Ort::Value output_tensor = Ort::Value::CreateTensor<float>(
+                memory_info_, output_data_.data(), count, shape, 2);
+
+            const char* input_name = "input";
+            const char* output_name = "output";
+            session_.Run(Ort::RunOptions{nullptr},
+                         &input_name, &input_tensor, 1,
+                         &output_name, &output_tensor, 1);
+
+            // Scatter the outputs back to the waiting callers.
+            for (size_t i = 0; i < count; ++i) {
+                batch_[i].result.set_value(output_data_[i]);
+            }
+        } catch (...) {
+            for (auto& request : batch_) {
+                request.result.set_exception(std::current_exception());
+            }
+        }
+
+        batches_run_ += 1;
+        requests_served_ += count;
+        batch_.clear();
+    }
+
+    Ort::Session& session_;
+    Options options_;
+    Ort::MemoryInfo memory_info_;
+
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::deque<Request> queue_;
+    bool stopping_ = false;
+
+    // Only touched by the worker thread; kept as members so their capacity is reused.
+    std::vector<Request> batch_;
+    std::vector<float> input_data_;
+    std::vector<float> output_data_;
+    std::atomic<size_t> batches_run_{0};
+    std::atomic<size_t> requests_served_{0};
+
+    std::thread worker_;
+};
@@ -0,0 +1,344 @@
+#include <iostream> // For standard input/output operations (e.g., std::cout, std::cerr)
+#include <vector>   // For std::vector to hold the workers
+#include <string>   // For std::string to handle paths and argument parsing
+#include <cstdlib>  // For EXIT_FAILURE/EXIT_SUCCESS
+#include <cstring>  // For std::strcmp
+#include <cerrno>   // For errno
+#include <chrono>   // For timing session creation
+#include <cmath>    // For std::fabs
+#include <memory>   // For std::unique_ptr sessions
+#include <iomanip>  // For std::setw
+#include <stdexcept> // For std::invalid_argument
+
+// POSIX headers for fork, pipes, waitpid and reading files
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+// ONNX Runtime C++ API header file
+#include <onnxruntime_cxx_api.h>
+
+#include "inference_runner.h"
+#include "mapped_model.h"
+#include "process_stats.h"
+
+// Compares loading a model by path with loading it from a memory-mapped file
+// (MappedModel, mapped_model.h) in several worker processes at once.
+//
+// For each mode, --workers child processes are forked. Each one creates its
+// session, runs it once, and reports its startup time. Once every worker has
+// loaded, each reports its RSS and PSS while all of them are still alive.
+// RSS counts every page a process touches, shared or not. PSS (proportional
+// set size) splits a page shared by N processes into N parts, so it shows
+// how much memory each worker really adds. With a path load every worker
+// holds its own copy of the weights. With an mmap load of an ORT-format
+// model, or of an .onnx model's external data, the workers share one copy
+// in the page cache. MappedModel also disables weight prepacking, which would
+// give every worker a private packed copy again; --prepack turns it back on
+// to show that. Before either mode runs, the model and its external data are
+// read once untimed, so both start with the files in the page cache and the
+// startup comparison doesn't depend on which mode goes first. With more than
+// one worker, the run fails unless the mmap load's PSS per worker is clearly
+// (25%) below the path load's.
+//
+// data/linear/linear.py writes a large model with ~64 MB of weights for this,
+// both as linear_large.ort and as linear_large.onnx + linear_large.onnx.data:
+//
+//   ./linear_mmap --model data/linear/linear_large.ort --workers 4
+//   ./linear_mmap --model data/linear/linear_large.onnx --external linear_large.onnx.data --workers 4
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// Sent from a worker to the parent through a pipe.
+struct WorkerReport {
+    double load_ms = 0.0;
+    size_t rss_before = 0; // Before the Env and session existed.
+    size_t rss = 0;
+    size_t pss = 0;
+    bool ok = false;
+};
+
+bool read_all(int fd, void* data, size_t size) {
+    char* bytes = static_cast<char*>(data);
+    while (size > 0) {
+        ssize_t received = ::read(fd, bytes, size);
+        if (received < 0 && errno == EINTR) {
+            continue;
+        }
+        if (received <= 0) {
+            return false;
+        }
+        bytes += received;
+        size -= static_cast<size_t>(received);
+    }
+    return true;
+}
+
+bool write_all(int fd, const void* data, size_t size) {
+    const char* bytes = static_cast<const char*>(data);
+    while (size > 0) {
+        ssize_t written = ::write(fd, bytes, size);
+        if (written < 0 && errno == EINTR) {
+            continue;
+        }
+        if (written <= 0) {
+            return false;
+        }
+        bytes += written;
+        size -= static_cast<size_t>(written);
+    }
+    return true;
+}
+
+// Reads a file once and discards the bytes, leaving it in the page cache.
+// Returns the number of bytes read, or 0 if it could not be opened.
+size_t warm_page_cache(const std::string& path) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return 0;
+    }
+    std::vector<char> buffer(1 << 20);
+    size_t total = 0;
+    ssize_t received;
+    while ((received = ::read(fd, buffer.data(), buffer.size())) != 0) {
+        if (received < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            break;
+        }
+        total += static_cast<size_t>(received);
+    }
+    ::close(fd);
+    return total;
+}
+
+// Body of one worker process: load, check, say "ready", wait for "go"
+// (the parent closing go_fd's other end), then report memory usage.
+void run_worker(bool use_mmap, const std::string& model_path, const MappedModelOptions& mapped_options,
+                int report_fd, int go_fd) {
+    WorkerReport report;
+    report.rss_before = current_rss_bytes();
+    // Declared outside the try block so the session stays alive while memory is measured.
+    std::unique_ptr<Ort::Env> env;
+    std::unique_ptr<Ort::Session> path_session;
+    std::unique_ptr<MappedModel> mapped_model;
+    try {
+        auto begin = Clock::now();
+        env = std::make_unique<Ort::Env>(ORT_LOGGING_LEVEL_WARNING, "linear_mmap");
+        Ort::SessionOptions session_options;
+        session_options.SetIntraOpNumThreads(1);
+        Ort::Session* session;
+        if (use_mmap) {
+            mapped_model = std::make_unique<MappedModel>(*env, model_path, session_options, mapped_options);
+            session = &mapped_model->session();
+        } else {
+            path_session = std::make_unique<Ort::Session>(*env, model_path.c_str(), session_options);
+            session = path_session.get();
+        }
+        report.load_ms = std::chrono::duration<double, std::milli>(Clock::now() - begin).count();
+
+        // The large model computes y = 2x like linear.onnx, up to float rounding.
+        InferenceRunner runner(*session);
+        std::vector<float> input = {0.5f, 1.0f, 2.0f, 10.0f};
+        Span<const float> output = runner.run(input);
+        report.ok = output.size() == input.size();
+        for (size_t i = 0; report.ok && i < input.size(); ++i) {
+            report.ok = std::fabs(output[i] - 2.0f * input[i]) <= 1e-3f * (1.0f + std::fabs(2.0f * input[i]));
+        }
+    } catch (const std::exception& ex) {
+        std::cerr << "Worker " << ::getpid() << ": " << ex.what() << std::endl;
+    }
+
+    char ready = 1;
+    write_all(report_fd, &ready, 1);
+    char unused;
+    while (::read(go_fd, &unused, 1) > 0) {
+    }
+    report.rss = current_rss_bytes();
+    report.pss = current_pss_bytes();
+    write_all(report_fd, &report, sizeof(report));
+}
+
+// Forks num_workers workers, lets them all load, then collects their reports.
+std::vector<WorkerReport> run_workers(int num_workers, bool use_mmap, const std::string& model_path,
+                                      const MappedModelOptions& mapped_options) {
+    int go_pipe[2];
+    if (::pipe(go_pipe) < 0) {
+        throw std::runtime_error("pipe failed");
+    }
+    std::vector<int> report_fds;
+    std::vector<pid_t> pids;
+    for (int w = 0; w < num_workers; ++w) {
+        int report_pipe[2];
+        if (::pipe(report_pipe) < 0) {
+            throw std::runtime_error("pipe failed");
+        }
+        pid_t pid = ::fork();
+        if (pid < 0) {
+            throw std::runtime_error("fork failed");
+        }
+        if (pid == 0) {
+            ::close(go_pipe[1]);
+            ::close(report_pipe[0]);
+            run_worker(use_mmap, model_path, mapped_options, report_pipe[1], go_pipe[0]);
+            std::cout.flush();
+            std::cerr.flush();
+            ::_exit(0); // Skip the parent's atexit handlers and static destructors.
+        }
+        ::close(report_pipe[1]);
+        report_fds.push_back(report_pipe[0]);
+        pids.push_back(pid);
+    }
+    ::close(go_pipe[0]);
+
+    // --- Wait until every worker has loaded, then release them all at once ---
+    std::vector<bool> alive(num_workers, true);
+    for (int w = 0; w < num_workers; ++w) {
+        char ready;
+        alive[w] = read_all(report_fds[w], &ready, 1);
+    }
+    ::close(go_pipe[1]);
+
+    std::vector<WorkerReport> reports(num_workers);
+    for (int w = 0; w < num_workers; ++w) {
+        if (!alive[w] || !read_all(report_fds[w], &reports[w], sizeof(WorkerReport))) {
+            reports[w] = WorkerReport(); // Crashed: ok stays false.
+        }
+        ::close(report_fds[w]);
+        ::waitpid(pids[w], nullptr, 0);
+    }
+    return reports;
+}
+
+double to_mib(size_t bytes) {
+    return bytes / (1024.0 * 1024.0);
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::string model_path = "data/linear/linear_large.ort";
+    int num_workers = 4;
+    bool run_path = true;
+    bool run_mmap = true;
+    MappedModelOptions mapped_options;
+
+    try {
+        for (int i = 1; i < argc; ++i) {
+            if (std::strcmp(argv[i], "--model") == 0 && i + 1 < argc) {
+                model_path = argv[++i];
+            } else if (std::strcmp(argv[i], "--external") == 0 && i + 1 < argc) {
+                mapped_options.external_data_files.push_back(argv[++i]);
+            } else if (std::strcmp(argv[i], "--workers") == 0 && i + 1 < argc) {
+                num_workers = std::stoi(argv[++i]);
+            } else if (std::strcmp(argv[i], "--mode") == 0 && i + 1 < argc) {
+                std::string mode = argv[++i];
+                if (mode != "path" && mode != "mmap" && mode != "both") {
+                    throw std::invalid_argument(mode);
+                }
+                run_path = mode != "mmap";
+                run_mmap = mode != "path";
+            } else if (std::strcmp(argv[i], "--prefetch") == 0) {
+                mapped_options.prefetch = true;
+            } else if (std::strcmp(argv[i], "--copy-initializers") == 0) {
+                mapped_options.use_bytes_for_initializers = false;
+            } else if (std::strcmp(argv[i], "--prepack") == 0) {
+                mapped_options.disable_prepacking = false;
+            } else {
+                throw std::invalid_argument(argv[i]);
+            }
+        }
+    } catch (const std::exception&) {
+        std::cerr << "Usage: " << argv[0] << " [--model <model_path>] [--external <data_file>]... [--workers N]"
+                  << " [--mode path|mmap|both] [--prefetch] [--copy-initializers] [--prepack]" << std::endl;
+        return EXIT_FAILURE;
+    }
+    if (num_workers <= 0) {
+        std::cerr << "Error: --workers must be positive." << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // No ORT objects may exist in this process before fork(), so only check the file here.
+    struct stat model_info;
+    if (::stat(model_path.c_str(), &model_info) < 0) {
+        std::cerr << "Error: cannot find " << model_path << " (run data/linear/linear.py to create it)" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    try {
+        std::cout << "Model: " << model_path << " (" << to_mib(static_cast<size_t>(model_info.st_size)) << " MiB";
+        for (const std::string& name : mapped_options.external_data_files) {
+            std::cout << " + " << name;
+        }
+        std::cout << "), workers: " << num_workers << std::endl;
+        // Warm the page cache so the first mode doesn't pay for the disk reads alone.
+        size_t warmed = warm_page_cache(model_path);
+        size_t slash = model_path.find_last_of('/');
+        std::string directory = slash == std::string::npos ? "" : model_path.substr(0, slash + 1);
+        for (const std::string& name : mapped_options.external_data_files) {
+            warmed += warm_page_cache(directory + name);
+        }
+        std::cout << "Page cache warmed with " << to_mib(warmed) << " MiB before timing" << std::endl;
+
+        std::cout << "\n" << std::setw(6) << "Mode" << std::setw(14) << "Startup(ms)" << std::setw(14) << "RSS(MiB)"
+                  << std::setw(14) << "PSS(MiB)" << std::setw(16) << "Growth(MiB)" << std::endl;
+
+        bool passed = true;
+        double path_load_ms = 0.0;
+        double path_pss = 0.0;
+        for (int mode = 0; mode < 2; ++mode) {
+            bool use_mmap = mode == 1;
+            if ((use_mmap && !run_mmap) || (!use_mmap && !run_path)) {
+                continue;
+            }
+            std::vector<WorkerReport> reports = run_workers(num_workers, use_mmap, model_path, mapped_options);
+
+            // Averages per worker; growth is RSS added by creating the Env and session.
+            double load_ms = 0.0, rss = 0.0, pss = 0.0, growth = 0.0;
+            for (const WorkerReport& report : reports) {
+                passed = passed && report.ok;
+                load_ms += report.load_ms / num_workers;
+                rss += to_mib(report.rss) / num_workers;
+                pss += to_mib(report.pss) / num_workers;
+                growth += (to_mib(report.rss) - to_mib(report.rss_before)) / num_workers;
+            }
+            std::cout << std::setw(6) << (use_mmap ? "mmap" : "path") << std::fixed << std::setprecision(2)
+                      << std::setw(14) << load_ms << std::setw(14) << rss << std::setw(14) << pss
+                      << std::setw(16) << growth << std::endl;
+            std::cout.unsetf(std::ios::fixed);
+
+            if (!use_mmap) {
+                path_load_ms = load_ms;
+                path_pss = pss;
+            } else if (run_path) {
+                std::cout << "\nmmap vs path: startup time " << (path_load_ms > 0.0 ? 100.0 * load_ms / path_load_ms : 0.0)
+                          << "%, PSS per worker " << (path_pss > 0.0 ? 100.0 * pss / path_pss : 0.0)
+                          << "% of the path load" << std::endl;
+                // One worker has nobody to share with, so only check with several.
+                if (num_workers > 1 && pss >= 0.75 * path_pss) {
+                    std::cout << "mmap did not share the weights: keep them in an .ort file or external data,"
+                              << " and don't use --prepack or --copy-initializers" << std::endl;
+                    passed = false;
+                }
+            }
+        }
+
+        std::cout << "Test " << (passed ? "PASSED" : "FAILED") << std::endl;
+        if (!passed) {
+            return EXIT_FAILURE;
+        }
+
+    } catch (const Ort::Exception& ex) {
+        std::cerr << "ONNX Runtime Error: " << ex.what() << std::endl;
+        return EXIT_FAILURE;
+    } catch (const std::exception& ex) {
+        std::cerr << "Standard C++ Error: " << ex.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
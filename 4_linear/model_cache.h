@@ -0,0 +1,188 @@
+#pragma once
+
+#include <cstdint>   // For uint64_t hashes
+#include <cstdio>    // For std::FILE, std::rename, std::remove
+#include <fstream>   // For reading /proc/cpuinfo
+#include <stdexcept> // For std::runtime_error
+#include <string>    // For std::string paths
+#include <vector>    // For the provider list
+
+#include <sys/stat.h> // For stat/mkdir
+#include <unistd.h>   // For getpid
+
+// ONNX Runtime C++ API header file
+#include <onnxruntime_cxx_api.h>
+
+// On-disk cache of graph-optimized models.
+//
+// Creating a session from a raw .onnx file re-runs graph optimizations on every
+// start. create_cached_session() instead looks for a previously optimized copy
+// of the model in cache_dir, keyed by a hash of the model bytes, the
+// optimization level, the output format, the ONNX Runtime version, the
+// execution providers and the CPU. On a hit the cached copy is loaded with
+// optimizations disabled; on a miss the model is optimized once and ORT writes
+// the result (SetOptimizedModelFilePath) for the next start.
+//
+// Extended and "all" optimizations can fuse nodes into kernels that only some
+// providers or CPUs (e.g. with AVX-512) implement, so a model optimized on one
+// machine may not load or may run differently on another. That is why the
+// providers and the CPU are part of the key: replicas sharing a cache directory
+// on different hardware or with different providers each get their own entry.
+
+struct ModelCacheOptions {
+    std::string cache_dir;   // Empty: no caching, just apply the optimization level.
+    GraphOptimizationLevel optimization_level = ORT_ENABLE_ALL;
+    bool ort_format = false; // Save the ORT format (.ort) instead of an optimized .onnx.
+    // Execution providers appended to the session options, in order (e.g.
+    // {"DNNL"}). Only used for the cache key; the caller still appends them.
+    std::vector<std::string> providers;
+};
+
+struct ModelCacheResult {
+    bool cache_hit = false;
+    std::string loaded_path; // The file the session was actually created from.
+};
+
+// Parses "disable", "basic", "extended" or "all".
+inline GraphOptimizationLevel parse_optimization_level(const std::string& name) {
+    if (name == "disable") {
+        return ORT_DISABLE_ALL;
+    }
+    if (name == "basic") {
+        return ORT_ENABLE_BASIC;
+    }
+    if (name == "extended") {
+        return ORT_ENABLE_EXTENDED;
+    }
+    if (name == "all") {
+        return ORT_ENABLE_ALL;
+    }
+    throw std::invalid_argument("unknown optimization level: " + name +
+                                " (expected disable, basic, extended or all)");
+}
+
+// 64-bit FNV-1a, fed incrementally.
+inline uint64_t fnv1a_update(uint64_t hash, const void* data, size_t size) {
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= bytes[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+// Identifies the CPU model and its instruction set extensions: the vendor,
+// model name and flags of the first processor in /proc/cpuinfo, hashed.
+// Returns "unknown-cpu" where /proc/cpuinfo is not available.
+inline std::string cpu_identifier() {
+    std::ifstream cpuinfo("/proc/cpuinfo");
+    std::string line;
+    std::string description;
+    while (std::getline(cpuinfo, line) && !line.empty()) { // The first processor ends at a blank line.
+        std::string key = line.substr(0, line.find(':'));
+        key.erase(key.find_last_not_of(" \t") + 1);
+        // x86 reports vendor_id/model/model name/flags, ARM reports CPU implementer/CPU part/Features.
+        if (key == "vendor_id" || key == "model" || key == "model name" || key == "flags" ||
+            key == "CPU implementer" || key == "CPU part" || key == "Features") {
+            description += line + "\n";
+        }
+    }
+    if (description.empty()) {
+        return "unknown-cpu";
+    }
+    char hex[17];
+    std::snprintf(hex, sizeof(hex), "%016llx",
+                  static_cast<unsigned long long>(fnv1a_update(14695981039346656037ULL, description.data(), description.size())));
+    return hex;
+}
+
+// Hashes the model file together with everything that changes the optimized output.
+inline uint64_t model_cache_key(const std::string& model_path, const ModelCacheOptions& options) {
+    uint64_t hash = 14695981039346656037ULL;
+    std::FILE* file = std::fopen(model_path.c_str(), "rb");
+    if (file == nullptr) {
+        throw std::runtime_error("cannot open model file: " + model_path);
+    }
+    char buffer[1 << 16];
+    size_t read;
+    while ((read = std::fread(buffer, 1, sizeof(buffer), file)) > 0) {
+        hash = fnv1a_update(hash, buffer, read);
+    }
+    std::fclose(file);
+
+    std::string settings = std::to_string(static_cast<int>(options.optimization_level)) +
+                           (options.ort_format ? "|ort|" : "|onnx|") + Ort::GetVersionString() + "|" + cpu_identifier();
+    for (const std::string& provider : options.providers) {
+        settings += "|" + provider;
+    }
+    return fnv1a_update(hash, settings.data(), settings.size());
+}
+
+inline bool file_exists(const std::string& path) {
+    struct stat info;
+    return ::stat(path.c_str(), &info) == 0 && S_ISREG(info.st_mode);
+}
+
+// Creates a session for model_path, going through the optimized-model cache when
+// options.cache_dir is set. session_options is not modified: the optimization
+// level and load format go on a clone, so the same options can be passed again,
+// e.g. for every reload of a watched model.
+inline Ort::Session create_cached_session(Ort::Env& env, const std::string& model_path,
+                                          const Ort::SessionOptions& session_options,
+                                          const ModelCacheOptions& options,
+                                          ModelCacheResult* result = nullptr) {
+    ModelCacheResult local_result;
+    ModelCacheResult& out = result != nullptr ? *result : local_result;
+
+    if (options.cache_dir.empty()) {
+        Ort::SessionOptions plain_options = session_options.Clone();
+        plain_options.SetGraphOptimizationLevel(options.optimization_level);
+        out.cache_hit = false;
+        out.loaded_path = model_path;
+        return Ort::Session(env, model_path.c_str(), plain_options);
+    }
+
+    // Name the entry after the model file so the cache directory stays readable.
+    size_t slash = model_path.find_last_of('/');
+    std::string stem = model_path.substr(slash == std::string::npos ? 0 : slash + 1);
+    size_t dot = stem.find_last_of('.');
+    if (dot != std::string::npos) {
+        stem.resize(dot);
+    }
+    char key[17];
+    std::snprintf(key, sizeof(key), "%016llx", static_cast<unsigned long long>(model_cache_key(model_path, options)));
+    std::string cached_path = options.cache_dir + "/" + stem + "-" + key + (options.ort_format ? ".ort" : ".onnx");
+
+    // --- Cache hit: the graph is already optimized, so skip optimization entirely ---
+    if (file_exists(cached_path)) {
+        Ort::SessionOptions hit_options = session_options.Clone();
+        hit_options.SetGraphOptimizationLevel(ORT_DISABLE_ALL);
+        if (options.ort_format) {
+            hit_options.AddConfigEntry("session.load_model_format", "ORT");
+        }
+        out.cache_hit = true;
+        out.loaded_path = cached_path;
+        return Ort::Session(env, cached_path.c_str(), hit_options);
+    }
+
+    // --- Cache miss: optimize the raw model and let ORT save the result ---
+    ::mkdir(options.cache_dir.c_str(), 0755); // Fails harmlessly if it already exists.
+    // Write to a per-process temporary name and rename it into place, so replicas
+    // starting at the same time never load a half-written file.
+    std::string temp_path = cached_path + ".tmp." + std::to_string(::getpid());
+    Ort::SessionOptions optimize_options = session_options.Clone();
+    optimize_options.SetGraphOptimizationLevel(options.optimization_level);
+    optimize_options.SetOptimizedModelFilePath(temp_path.c_str());
+    if (options.ort_format) {
+        // The raw model is still .onnx; only the saved copy is ORT format.
+        optimize_options.AddConfigEntry("session.save_model_format", "ORT");
+    }
+    Ort::Session session(env, model_path.c_str(), optimize_options);
+    if (std::rename(temp_path.c_str(), cached_path.c_str()) != 0) {
+        std::remove(temp_path.c_str());
+    }
+
+    out.cache_hit = false;
+    out.loaded_path = model_path;
+    return session;
+}
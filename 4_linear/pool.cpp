@@ -0,0 +1,176 @@
+#include <iostream> // For standard input/output operations (e.g., std::cout, std::cerr)
+#include <vector>   // For std::vector to hold the batch and per-thread results
+#include <string>   // For std::string to handle argument parsing
+#include <cstdlib>  // For EXIT_FAILURE/EXIT_SUCCESS
+#include <cstring>  // For std::strcmp
+#include <chrono>   // For timing the runs
+#include <thread>   // For the runner threads
+#include <exception> // For passing errors out of the runner threads
+#include <cmath>    // For std::round
+#include <stdexcept> // For std::invalid_argument
+#include <algorithm> // For std::max
+
+// ONNX Runtime C++ API header file
+#include <onnxruntime_cxx_api.h>
+
+#include "latency_stats.h"
+#include "session_pool.h"
+#include "staging_pool.h"
+
+// Scales inference across cores with a SessionPool: one thread per runner,
+// each optionally pinned to its own core, all running batches concurrently.
+// --pin pins only the runner threads; ORT's intra-op threads are not pinned,
+// so use it with --intra 1 for one core per runner.
+//
+//   ./linear_pool --runners 8 --intra 1 --pin
+//   ./linear_pool --runners 8 --shared --global-pool --intra 8 --no-spin
+//   ./linear_pool --runners 8 --env-allocator --arena-extend same --initial-chunk 1048576
+
+int main(int argc, char* argv[]) {
+    const char* model_path = "data/linear/linear.onnx";
+    SessionPoolOptions options;
+    options.num_runners = std::max(1u, std::thread::hardware_concurrency());
+    size_t batch_size = 256;
+    int iterations = 2000;
+
+    try {
+        for (int i = 1; i < argc; ++i) {
+            if (std::strcmp(argv[i], "--runners") == 0 && i + 1 < argc) {
+                options.num_runners = std::stoul(argv[++i]);
+            } else if (std::strcmp(argv[i], "--intra") == 0 && i + 1 < argc) {
+                options.intra_op_threads = std::stoi(argv[++i]);
+            } else if (std::strcmp(argv[i], "--inter") == 0 && i + 1 < argc) {
+                options.inter_op_threads = std::stoi(argv[++i]);
+                options.parallel_execution = true;
+            } else if (std::strcmp(argv[i], "--shared") == 0) {
+                options.share_session = true;
+            } else if (std::strcmp(argv[i], "--global-pool") == 0) {
+                options.use_global_thread_pool = true;
+            } else if (std::strcmp(argv[i], "--no-spin") == 0) {
+                options.allow_spinning = false;
+            } else if (std::strcmp(argv[i], "--pin") == 0) {
+                options.pin_to_cores = true;
+            } else if (std::strcmp(argv[i], "--env-allocator") == 0) {
+                options.use_env_allocator = true;
+            } else if (std::strcmp(argv[i], "--arena-extend") == 0 && i + 1 < argc) {
+                std::string strategy = argv[++i];
+                if (strategy != "pow2" && strategy != "same") {
+                    throw std::invalid_argument(strategy);
+                }
+                options.arena_extend_strategy = strategy == "pow2" ? 0 : 1;
+            } else if (std::strcmp(argv[i], "--initial-chunk") == 0 && i + 1 < argc) {
+                options.arena_initial_chunk_bytes = std::stoi(argv[++i]);
+            } else if (std::strcmp(argv[i], "--arena-max") == 0 && i + 1 < argc) {
+                options.arena_max_bytes = std::stoul(argv[++i]);
+            } else if (std::strcmp(argv[i], "--batch") == 0 && i + 1 < argc) {
+                batch_size = std::stoul(argv[++i]);
+            } else if (std::strcmp(argv[i], "--iterations") == 0 && i + 1 < argc) {
+                iterations = std::stoi(argv[++i]);
+            } else if (std::strcmp(argv[i], "--model") == 0 && i + 1 < argc) {
+                model_path = argv[++i];
+            } else {
+                throw std::invalid_argument(argv[i]);
+            }
+        }
+    } catch (const std::exception&) {
+        std::cerr << "Usage: " << argv[0] << " [--runners N] [--intra N] [--inter N] [--shared]"
+                  << " [--global-pool] [--no-spin] [--pin] [--env-allocator] [--arena-extend pow2|same]"
+                  << " [--initial-chunk BYTES] [--arena-max BYTES] [--batch N] [--iterations N]"
+                  << " [--model <model_path>]" << std::endl;
+        return EXIT_FAILURE;
+    }
+    if (options.num_runners == 0 || batch_size == 0 || iterations <= 0) {
+        std::cerr << "Error: --runners, --batch and --iterations must be positive." << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    try {
+        SessionPool pool(model_path, options);
+        std::cout << "Runners: " << pool.num_runners()
+                  << ", sessions: " << pool.num_sessions()
+                  << ", intra-op threads: " << options.intra_op_threads
+                  << ", inter-op threads: " << options.inter_op_threads
+                  << (options.use_global_thread_pool ? " (global pool)" : " (per session)")
+                  << ", spinning: " << (options.allow_spinning ? "on" : "off")
+                  << ", pinned: " << (options.pin_to_cores ? "yes" : "no")
+                  << ", arena: " << (options.use_env_allocator ? "shared (Env)" : "per session") << std::endl;
+
+        std::vector<LatencyStats> per_runner(pool.num_runners());
+        std::vector<char> passed(pool.num_runners(), 1); // Not vector<bool>: written concurrently.
+        std::vector<std::exception_ptr> errors(pool.num_runners());
+        std::vector<std::thread> workers;
+
+        auto begin = std::chrono::steady_clock::now();
+        for (size_t r = 0; r < pool.num_runners(); ++r) {
+            workers.emplace_back([&, r] {
+                try {
+                    if (options.pin_to_cores && !SessionPool::pin_current_thread(r)) {
+                        std::cerr << "Warning: could not pin runner " << r << std::endl;
+                    }
+                    auto memory_info = Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
+                    // Batch buffers come from this thread's staging pool instead of fresh vectors.
+                    StagingPool::StagingBuffer input_data = StagingPool::acquire(batch_size);
+                    StagingPool::StagingBuffer output_data = StagingPool::acquire(batch_size);
+                    for (size_t i = 0; i < batch_size; ++i) {
+                        input_data[i] = static_cast<float>(i % 100);
+                    }
+                    int64_t shape[2] = {static_cast<int64_t>(batch_size), 1};
+                    Ort::Value input_tensor = Ort::Value::CreateTensor<float>(
+                        memory_info, input_data.data(), batch_size, shape, 2);
+                    Ort::Value output_tensor = Ort::Value::CreateTensor<float>(
+                        memory_info, output_data.data(), batch_size, shape, 2);
+                    const char* input_name = "input";
+                    const char* output_name = "output";
+
+                    SessionPool::Lease lease = pool.acquire(r);
+                    per_runner[r].reserve(iterations);
+                    for (int i = 0; i < iterations; ++i) {
+                        auto run_begin = std::chrono::steady_clock::now();
+                        lease.session().Run(Ort::RunOptions{nullptr},
+                                            &input_name, &input_tensor, 1,
+                                            &output_name, &output_tensor, 1);
+                        per_runner[r].add(std::chrono::duration<double, std::micro>(
+                            std::chrono::steady_clock::now() - run_begin).count());
+                    }
+                    passed[r] = std::round(output_data[batch_size - 1]) == std::round(input_data[batch_size - 1] * 2.0f);
+                } catch (...) {
+                    errors[r] = std::current_exception();
+                }
+            });
+        }
+        for (auto& worker : workers) {
+            worker.join();
+        }
+        for (const std::exception_ptr& error : errors) {
+            if (error) {
+                std::rethrow_exception(error); // Reported by the handlers below.
+            }
+        }
+        double wall_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+        LatencyStats total;
+        bool all_passed = true;
+        for (size_t r = 0; r < pool.num_runners(); ++r) {
+            for (double sample : per_runner[r].samples()) {
+                total.add(sample);
+            }
+            all_passed = all_passed && passed[r];
+        }
+        std::cout << "\n--- Per-Run statistics (batch " << batch_size << ") ---" << std::endl;
+        total.print(std::cout, wall_seconds);
+        std::cout << "Items/sec: " << total.count() * batch_size / wall_seconds << std::endl;
+        std::cout << "Test " << (all_passed ? "PASSED" : "FAILED") << std::endl;
+        if (!all_passed) {
+            return EXIT_FAILURE;
+        }
+
+    } catch (const Ort::Exception& ex) {
+        std::cerr << "ONNX Runtime Error: " << ex.what() << std::endl;
+        return EXIT_FAILURE;
+    } catch (const std::exception& ex) {
+        std::cerr << "Standard C++ Error: " << ex.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,193 @@
+#include <iostream> // For standard input/output operations (e.g., std::cout, std::cerr)
+#include <fstream>  // For checking that a model variant exists
+#include <vector>   // For std::vector to hold the batch and the reference output
+#include <string>   // For std::string to handle paths and argument parsing
+#include <sstream>  // For splitting the variant list
+#include <cstdlib>  // For EXIT_FAILURE/EXIT_SUCCESS
+#include <cstring>  // For std::strcmp
+#include <chrono>   // For timing the runs
+#include <random>   // For generating the input batch
+#include <iomanip>  // For std::setw
+#include <stdexcept> // For std::invalid_argument
+
+// ONNX Runtime C++ API header file
+#include <onnxruntime_cxx_api.h>
+
+#include "inference_runner.h"
+#include "simd_prepost.h" // For check_scaled
+#include "tensor_info.h"  // For get_tensor_data_type_string
+
+// Compares the FP32 linear model with its reduced-precision variants.
+//
+// data/linear/linear.py writes linear.onnx (fp32), linear_fp16.onnx (float16
+// weights, input and output) and linear_int8.onnx (dynamically quantized INT8
+// weights, float input and output). Each variant runs the same batch through
+// InferenceRunner::run_converted, which converts the float input to the
+// model's input type and the output back to float, so the timings include
+// the conversions a caller with float data would pay.
+//
+// Every variant's output is checked against the FP32 output with
+// check_scaled (|variant - fp32| <= abs + rel * |fp32|); a variant outside the
+// tolerance fails the run. Variants whose model file is missing are skipped.
+//
+//   ./linear_precision
+//   ./linear_precision --variants fp32,int8 --batch 1000000 --abs-tolerance 0.1
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Variant {
+    std::string name;
+    std::string file;
+};
+
+Variant find_variant(const std::string& name) {
+    if (name == "fp32") return {name, "linear.onnx"};
+    if (name == "fp16") return {name, "linear_fp16.onnx"};
+    if (name == "int8") return {name, "linear_int8.onnx"};
+    throw std::invalid_argument("unknown variant: " + name);
+}
+
+bool file_exists(const std::string& path) {
+    return std::ifstream(path).good();
+}
+
+// Average milliseconds per run_converted call over `iterations` runs, after one warm-up run.
+double time_runs(InferenceRunner& runner, const std::vector<float>& input, int iterations, std::vector<float>& output) {
+    Span<const float> result = runner.run_converted(input);
+    auto begin = Clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        result = runner.run_converted(input);
+    }
+    double total_ms = std::chrono::duration<double, std::milli>(Clock::now() - begin).count();
+    output.assign(result.begin(), result.end());
+    return total_ms / iterations;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::string model_dir = "data/linear";
+    std::string variant_list = "fp32,fp16,int8";
+    size_t batch_size = 65536;
+    int iterations = 50;
+    float input_range = 10.0f;
+    float abs_tolerance = 0.25f;
+    float rel_tolerance = 0.01f;
+
+    try {
+        for (int i = 1; i < argc; ++i) {
+            if (std::strcmp(argv[i], "--model-dir") == 0 && i + 1 < argc) {
+                model_dir = argv[++i];
+            } else if (std::strcmp(argv[i], "--variants") == 0 && i + 1 < argc) {
+                variant_list = argv[++i];
+            } else if (std::strcmp(argv[i], "--batch") == 0 && i + 1 < argc) {
+                batch_size = std::stoul(argv[++i]);
+            } else if (std::strcmp(argv[i], "--iterations") == 0 && i + 1 < argc) {
+                iterations = std::stoi(argv[++i]);
+            } else if (std::strcmp(argv[i], "--range") == 0 && i + 1 < argc) {
+                input_range = std::stof(argv[++i]);
+            } else if (std::strcmp(argv[i], "--abs-tolerance") == 0 && i + 1 < argc) {
+                abs_tolerance = std::stof(argv[++i]);
+            } else if (std::strcmp(argv[i], "--rel-tolerance") == 0 && i + 1 < argc) {
+                rel_tolerance = std::stof(argv[++i]);
+            } else {
+                throw std::invalid_argument(argv[i]);
+            }
+        }
+    } catch (const std::exception&) {
+        std::cerr << "Usage: " << argv[0] << " [--model-dir <dir>] [--variants fp32,fp16,int8] [--batch N]"
+                  << " [--iterations N] [--range R] [--abs-tolerance A] [--rel-tolerance R]" << std::endl;
+        return EXIT_FAILURE;
+    }
+    if (batch_size == 0 || iterations <= 0 || input_range <= 0.0f) {
+        std::cerr << "Error: --batch, --iterations and --range must be positive." << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::vector<Variant> variants;
+    try {
+        std::stringstream stream(variant_list);
+        std::string name;
+        while (std::getline(stream, name, ',')) {
+            variants.push_back(find_variant(name));
+        }
+    } catch (const std::exception& ex) {
+        std::cerr << "Error: " << ex.what() << " (expected fp32, fp16 or int8)" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    try {
+        // --- Input batch: uniform values in [-range, range] ---
+        std::vector<float> input(batch_size);
+        std::mt19937 rng(42);
+        std::uniform_real_distribution<float> dist(-input_range, input_range);
+        for (float& value : input) {
+            value = dist(rng);
+        }
+
+        Ort::Env env(ORT_LOGGING_LEVEL_WARNING, "linear_precision");
+
+        // --- FP32 reference output and time ---
+        const std::string reference_path = model_dir + "/linear.onnx";
+        InferenceRunner reference(env, reference_path.c_str());
+        std::vector<float> reference_output;
+        double reference_ms = time_runs(reference, input, iterations, reference_output);
+
+        std::cout << "Batch: " << batch_size << ", iterations: " << iterations << ", input range: +/-" << input_range
+                  << ", tolerance: " << abs_tolerance << " + " << rel_tolerance << " * |fp32|" << std::endl;
+        std::cout << "\n" << std::left << std::setw(8) << "Variant" << std::setw(18) << "Types(in->out)"
+                  << std::right << std::setw(12) << "ms/run" << std::setw(14) << "Mrows/s" << std::setw(10) << "vs fp32"
+                  << std::setw(14) << "Max abs err" << std::setw(10) << "Failures" << "  Result" << std::endl;
+
+        bool passed = true;
+        for (const Variant& variant : variants) {
+            const std::string path = model_dir + "/" + variant.file;
+            if (!file_exists(path)) {
+                std::cout << std::left << std::setw(8) << variant.name << "skipped: " << path
+                          << " not found (run data/linear/linear.py)" << std::endl;
+                continue;
+            }
+
+            InferenceRunner runner(env, path.c_str());
+            std::vector<float> output;
+            double ms = time_runs(runner, input, iterations, output);
+            if (output.size() != reference_output.size()) {
+                // check_scaled reads output.size() values from both, so don't compare at all.
+                std::cout << std::left << std::setw(8) << variant.name << "FAILED: " << output.size()
+                          << " outputs, fp32 has " << reference_output.size() << std::endl;
+                passed = false;
+                continue;
+            }
+            ToleranceCheck check = check_scaled(reference_output.data(), output.data(), output.size(), 1.0f,
+                                                abs_tolerance, rel_tolerance);
+            bool ok = check.failures == 0;
+            passed = passed && ok;
+
+            std::string types = get_tensor_data_type_string(runner.inputs()[0].type) + "->" +
+                                get_tensor_data_type_string(runner.outputs()[0].type);
+            std::cout << std::left << std::setw(8) << variant.name << std::setw(18) << types << std::right
+                      << std::fixed << std::setprecision(3) << std::setw(12) << ms
+                      << std::setw(14) << batch_size / ms / 1000.0
+                      << std::setw(9) << reference_ms / ms << "x"
+                      << std::setprecision(5) << std::setw(14) << check.max_abs_error
+                      << std::setw(10) << check.failures << "  " << (ok ? "ok" : "out of tolerance") << std::endl;
+            std::cout.unsetf(std::ios::fixed);
+        }
+
+        std::cout << "\nTest " << (passed ? "PASSED" : "FAILED") << std::endl;
+        if (!passed) {
+            return EXIT_FAILURE;
+        }
+
+    } catch (const Ort::Exception& ex) {
+        std::cerr << "ONNX Runtime Error: " << ex.what() << std::endl;
+        return EXIT_FAILURE;
+    } catch (const std::exception& ex) {
+        std::cerr << "Standard C++ Error: " << ex.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,215 @@
+#include <iostream> // For standard input/output operations (e.g., std::cout, std::cerr)
+#include <fstream>  // For the per-line output of the baseline
+#include <sstream>  // For the token splitting of the baseline
+#include <vector>   // For std::vector to hold the batch
+#include <string>   // For std::string to handle the text and argument parsing
+#include <cstdio>   // For std::FILE output of the vectorized path
+#include <cstdlib>  // For EXIT_FAILURE/EXIT_SUCCESS
+#include <cstring>  // For std::strcmp, std::memcmp
+#include <chrono>   // For timing each stage
+#include <cmath>    // For std::round
+#include <random>   // For generating the input rows
+#include <iomanip>  // For std::setw
+#include <algorithm> // For std::min
+#include <stdexcept> // For std::runtime_error
+
+// ONNX Runtime C++ API header file
+#include <onnxruntime_cxx_api.h>
+
+#include "simd_prepost.h"
+
+// Times pre/post-processing against the model itself for one large batch.
+//
+// The baseline does what main3.cpp used to do per value: std::stof on each
+// token, a std::round comparison against 2 * input, and one std::endl line
+// per result. The vectorized path uses simd_prepost.h: parse_floats, one fused
+// check_scaled pass and format_floats into a single buffer. Both paths read
+// the same generated text and must agree on every parsed value.
+//
+//   ./linear_prepost --rows 4000000
+//   ./linear_prepost --rows 1000000 --output out.txt
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double elapsed_ms(Clock::time_point begin) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - begin).count();
+}
+
+struct StageTimes {
+    double parse_ms = 0.0;
+    double check_ms = 0.0;
+    double format_ms = 0.0;
+    double total() const { return parse_ms + check_ms + format_ms; }
+};
+
+void print_row(const char* stage, double baseline_ms, double fast_ms) {
+    std::cout << std::left << std::setw(10) << stage << std::right << std::fixed << std::setprecision(2)
+              << std::setw(14) << baseline_ms << std::setw(14) << fast_ms
+              << std::setw(10) << baseline_ms / fast_ms << "x" << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    const char* model_path = "data/linear/linear.onnx";
+    const char* output_path = "/dev/null";
+    size_t rows = 4000000;
+
+    try {
+        for (int i = 1; i < argc; ++i) {
+            if (std::strcmp(argv[i], "--rows") == 0 && i + 1 < argc) {
+                rows = std::stoul(argv[++i]);
+            } else if (std::strcmp(argv[i], "--output") == 0 && i + 1 < argc) {
+                output_path = argv[++i];
+            } else if (std::strcmp(argv[i], "--model") == 0 && i + 1 < argc) {
+                model_path = argv[++i];
+            } else {
+                throw std::invalid_argument(argv[i]);
+            }
+        }
+    } catch (const std::exception&) {
+        std::cerr << "Usage: " << argv[0] << " [--rows N] [--output <file>] [--model <model_path>]" << std::endl;
+        return EXIT_FAILURE;
+    }
+    if (rows == 0) {
+        std::cerr << "Error: --rows must be positive." << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    try {
+        // --- Input text: one number per line, like a CSV column ---
+        std::string text;
+        {
+            std::mt19937 rng(42);
+            std::uniform_real_distribution<float> dist(-1000.0f, 1000.0f);
+            char line[32];
+            text.reserve(rows * 12);
+            for (size_t i = 0; i < rows; ++i) {
+                int length = std::snprintf(line, sizeof(line), "%.4f\n", dist(rng));
+                text.append(line, length);
+            }
+        }
+        std::cout << "Rows: " << rows << ", text: " << text.size() / (1024.0 * 1024.0) << " MiB"
+                  << ", vector ISA: " << simd_prepost_isa() << std::endl;
+
+        Ort::Env env(ORT_LOGGING_LEVEL_WARNING, "linear_prepost");
+        Ort::Session session(env, model_path, Ort::SessionOptions());
+        auto memory_info = Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
+        const char* input_name = "input";
+        const char* output_name = "output";
+        int64_t shape[2] = {static_cast<int64_t>(rows), 1};
+
+        // --- Baseline: per-value std::stof, std::round check and std::endl ---
+        StageTimes baseline;
+        std::vector<float> baseline_input;
+        std::vector<float> baseline_output(rows);
+        size_t baseline_failures = 0;
+        {
+            auto begin = Clock::now();
+            std::istringstream stream(text);
+            std::string token;
+            baseline_input.reserve(rows);
+            while (stream >> token) {
+                baseline_input.push_back(std::stof(token));
+            }
+            baseline.parse_ms = elapsed_ms(begin);
+
+            Ort::Value input_tensor = Ort::Value::CreateTensor<float>(
+                memory_info, baseline_input.data(), rows, shape, 2);
+            Ort::Value output_tensor = Ort::Value::CreateTensor<float>(
+                memory_info, baseline_output.data(), rows, shape, 2);
+            session.Run(Ort::RunOptions{nullptr}, &input_name, &input_tensor, 1, &output_name, &output_tensor, 1);
+
+            begin = Clock::now();
+            for (size_t i = 0; i < rows; ++i) {
+                if (std::round(baseline_output[i]) != std::round(baseline_input[i] * 2.0f)) {
+                    ++baseline_failures;
+                }
+            }
+            baseline.check_ms = elapsed_ms(begin);
+
+            begin = Clock::now();
+            std::ofstream out(output_path);
+            for (size_t i = 0; i < rows; ++i) {
+                out << baseline_output[i] << std::endl;
+            }
+            baseline.format_ms = elapsed_ms(begin);
+        }
+
+        // --- Vectorized: parse_floats, check_scaled and format_floats ---
+        StageTimes fast;
+        std::vector<float> fast_input(rows);
+        std::vector<float> fast_output(rows);
+        ToleranceCheck check;
+        double model_ms = 0.0;
+        {
+            auto begin = Clock::now();
+            size_t parsed = parse_floats(text.data(), text.data() + text.size(), fast_input.data(), rows);
+            fast.parse_ms = elapsed_ms(begin);
+            if (parsed != rows) {
+                throw std::runtime_error("parsed " + std::to_string(parsed) + " of " + std::to_string(rows) + " rows");
+            }
+
+            Ort::Value input_tensor = Ort::Value::CreateTensor<float>(
+                memory_info, fast_input.data(), rows, shape, 2);
+            Ort::Value output_tensor = Ort::Value::CreateTensor<float>(
+                memory_info, fast_output.data(), rows, shape, 2);
+            // Warm up once, then time the model on the same batch for comparison.
+            session.Run(Ort::RunOptions{nullptr}, &input_name, &input_tensor, 1, &output_name, &output_tensor, 1);
+            begin = Clock::now();
+            session.Run(Ort::RunOptions{nullptr}, &input_name, &input_tensor, 1, &output_name, &output_tensor, 1);
+            model_ms = elapsed_ms(begin);
+
+            begin = Clock::now();
+            check = check_scaled(fast_input.data(), fast_output.data(), rows, 2.0f, 0.5f);
+            fast.check_ms = elapsed_ms(begin);
+
+            // Format in 64 KiB-value pieces so the buffer stays small for any row count.
+            begin = Clock::now();
+            std::FILE* out = std::fopen(output_path, "wb");
+            if (out == nullptr) {
+                throw std::runtime_error(std::string("cannot open output file: ") + output_path);
+            }
+            const size_t piece = 65536;
+            std::vector<char> buffer(piece * (kMaxFloatChars + 1));
+            for (size_t i = 0; i < rows; i += piece) {
+                size_t count = std::min(piece, rows - i);
+                size_t bytes = format_floats(fast_output.data() + i, count, '\n', buffer.data());
+                std::fwrite(buffer.data(), 1, bytes, out);
+            }
+            std::fclose(out);
+            fast.format_ms = elapsed_ms(begin);
+        }
+
+        std::cout << "\n" << std::left << std::setw(10) << "Stage" << std::right << std::setw(14) << "Baseline(ms)"
+                  << std::setw(14) << "SIMD(ms)" << std::setw(11) << "Speedup" << std::endl;
+        print_row("parse", baseline.parse_ms, fast.parse_ms);
+        print_row("check", baseline.check_ms, fast.check_ms);
+        print_row("format", baseline.format_ms, fast.format_ms);
+        print_row("total", baseline.total(), fast.total());
+        std::cout << "\nModel Run: " << model_ms << " ms"
+                  << ", pre/post over model: baseline " << baseline.total() / model_ms
+                  << "x, SIMD " << fast.total() / model_ms << "x" << std::endl;
+        std::cout << "Max abs error: " << check.max_abs_error << ", failures: " << check.failures
+                  << " (baseline rounding check: " << baseline_failures << ")" << std::endl;
+
+        bool same_input = baseline_input.size() == rows &&
+                          std::memcmp(baseline_input.data(), fast_input.data(), rows * sizeof(float)) == 0;
+        bool passed = same_input && check.failures == 0;
+        std::cout << "Test " << (passed ? "PASSED" : "FAILED") << std::endl;
+        if (!passed) {
+            return EXIT_FAILURE;
+        }
+
+    } catch (const Ort::Exception& ex) {
+        std::cerr << "ONNX Runtime Error: " << ex.what() << std::endl;
+        return EXIT_FAILURE;
+    } catch (const std::exception& ex) {
+        std::cerr << "Standard C++ Error: " << ex.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
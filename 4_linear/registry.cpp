@@ -0,0 +1,199 @@
+#include <iostream> // For standard input/output operations (e.g., std::cout, std::cerr)
+#include <vector>   // For std::vector to hold names and request data
+#include <string>   // For std::string to handle names and argument parsing
+#include <cstdlib>  // For EXIT_FAILURE/EXIT_SUCCESS
+#include <cstring>  // For std::strcmp
+#include <chrono>   // For timing loads and requests
+#include <cmath>    // For std::round
+#include <random>   // For the skewed request mix
+#include <iomanip>  // For std::setw
+#include <stdexcept> // For std::invalid_argument
+
+// ONNX Runtime C++ API header file
+#include <onnxruntime_cxx_api.h>
+
+#include "model_registry.h"
+#include "process_stats.h"
+
+// Loads many copies of the linear model into one ModelRegistry and reports
+// how the process's thread count and RSS grow with the number of models.
+//
+// By default the registry shares one Env thread pool and CPU arena between
+// all sessions; --per-session-threads gives every session its own thread
+// pools and arena instead, for comparison (run the two modes as separate
+// processes so they don't share RSS). With --budget-mb, the request phase
+// hits the models with a skewed (Zipf-like) mix and the registry evicts least
+// recently used models to stay within the budget.
+//
+//   ./linear_registry --models 64
+//   ./linear_registry --models 64 --per-session-threads
+//   ./linear_registry --models 64 --budget-mb 4 --requests 50000
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double to_mib(size_t bytes) {
+    return bytes / (1024.0 * 1024.0);
+}
+
+void print_usage_row(size_t models, size_t threads, size_t rss_bytes, double load_ms) {
+    std::cout << std::setw(8) << models << std::setw(10) << threads << std::fixed << std::setprecision(1)
+              << std::setw(12) << to_mib(rss_bytes) << std::setprecision(3) << std::setw(14) << load_ms << std::endl;
+    std::cout.unsetf(std::ios::fixed);
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::string model_path = "data/linear/linear.onnx";
+    size_t num_models = 32;
+    size_t num_requests = 20000;
+    size_t batch_size = 16;
+    ModelRegistryOptions options;
+
+    try {
+        for (int i = 1; i < argc; ++i) {
+            if (std::strcmp(argv[i], "--models") == 0 && i + 1 < argc) {
+                num_models = std::stoul(argv[++i]);
+            } else if (std::strcmp(argv[i], "--per-session-threads") == 0) {
+                options.use_global_thread_pool = false;
+                options.use_env_allocator = false;
+            } else if (std::strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+                options.intra_op_threads = std::stoi(argv[++i]);
+            } else if (std::strcmp(argv[i], "--budget-mb") == 0 && i + 1 < argc) {
+                options.memory_budget_bytes = static_cast<size_t>(std::stod(argv[++i]) * 1024 * 1024);
+            } else if (std::strcmp(argv[i], "--requests") == 0 && i + 1 < argc) {
+                num_requests = std::stoul(argv[++i]);
+            } else if (std::strcmp(argv[i], "--batch") == 0 && i + 1 < argc) {
+                batch_size = std::stoul(argv[++i]);
+            } else if (std::strcmp(argv[i], "--model") == 0 && i + 1 < argc) {
+                model_path = argv[++i];
+            } else {
+                throw std::invalid_argument(argv[i]);
+            }
+        }
+    } catch (const std::exception&) {
+        std::cerr << "Usage: " << argv[0] << " [--models N] [--per-session-threads] [--threads N] [--budget-mb MB]"
+                  << " [--requests N] [--batch N] [--model <model_path>]" << std::endl;
+        return EXIT_FAILURE;
+    }
+    if (num_models == 0 || batch_size == 0) {
+        std::cerr << "Error: --models and --batch must be positive." << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    try {
+        size_t base_threads = current_thread_count();
+        size_t base_rss = current_rss_bytes();
+
+        ModelRegistry registry(options);
+        std::vector<std::string> names;
+        for (size_t m = 0; m < num_models; ++m) {
+            names.push_back("linear_" + std::to_string(m));
+            registry.add(names.back(), model_path);
+        }
+
+        std::cout << "Mode: " << (options.use_global_thread_pool ? "shared Env thread pool and arena"
+                                                                 : "per-session threads and arenas")
+                  << ", models: " << num_models << ", budget: "
+                  << (options.memory_budget_bytes == 0 ? std::string("none")
+                                                       : std::to_string(to_mib(options.memory_budget_bytes)) + " MiB")
+                  << std::endl;
+
+        // --- 1. Load the models one by one and sample threads/RSS at powers of two ---
+        // Each model is also run once: ORT starts some per-session threads lazily.
+        auto memory_info = Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
+        const char* input_name = "input";
+        const char* output_name = "output";
+        std::vector<float> input(batch_size);
+        std::vector<float> output(batch_size);
+        int64_t shape[2] = {static_cast<int64_t>(batch_size), 1};
+        auto run_once = [&](Ort::Session& session) {
+            Ort::Value input_tensor = Ort::Value::CreateTensor<float>(memory_info, input.data(), batch_size, shape, 2);
+            Ort::Value output_tensor = Ort::Value::CreateTensor<float>(memory_info, output.data(), batch_size, shape, 2);
+            session.Run(Ort::RunOptions{nullptr}, &input_name, &input_tensor, 1, &output_name, &output_tensor, 1);
+        };
+
+        std::cout << "\n" << std::setw(8) << "Models" << std::setw(10) << "Threads" << std::setw(12) << "RSS(MiB)"
+                  << std::setw(14) << "Load(ms)" << std::endl;
+        print_usage_row(0, base_threads, base_rss, 0.0);
+        size_t one_model_threads = 0;
+        size_t one_model_rss = 0;
+        size_t next_report = 1;
+        double load_ms = 0.0;
+        for (size_t m = 0; m < num_models; ++m) {
+            auto begin = Clock::now();
+            std::shared_ptr<Ort::Session> session = registry.get(names[m]);
+            run_once(*session);
+            load_ms += std::chrono::duration<double, std::milli>(Clock::now() - begin).count();
+            if (m + 1 == next_report || m + 1 == num_models) {
+                print_usage_row(m + 1, current_thread_count(), current_rss_bytes(), load_ms / (m + 1));
+                next_report *= 2;
+            }
+            if (m == 0) {
+                one_model_threads = current_thread_count();
+                one_model_rss = current_rss_bytes();
+            }
+        }
+        if (num_models > 1) {
+            size_t all_threads = current_thread_count();
+            size_t all_rss = current_rss_bytes();
+            std::cout << "\nPer additional model: " << (static_cast<double>(all_threads) - one_model_threads) / (num_models - 1)
+                      << " threads, " << (static_cast<double>(all_rss) - one_model_rss) / (num_models - 1) / 1024.0
+                      << " KiB RSS (first model: " << static_cast<double>(one_model_threads) - base_threads
+                      << " threads, " << (static_cast<double>(one_model_rss) - base_rss) / 1024.0 << " KiB)" << std::endl;
+        }
+
+        // --- 2. Skewed request mix: model m is picked with weight 1 / (m + 1) ---
+        std::vector<double> weights;
+        for (size_t m = 0; m < num_models; ++m) {
+            weights.push_back(1.0 / (m + 1));
+        }
+        std::discrete_distribution<size_t> pick(weights.begin(), weights.end());
+        std::mt19937 rng(42);
+        ModelRegistryStats before = registry.stats();
+        size_t failures = 0;
+        auto begin = Clock::now();
+        for (size_t r = 0; r < num_requests; ++r) {
+            for (size_t i = 0; i < batch_size; ++i) {
+                input[i] = static_cast<float>((r + i) % 100);
+            }
+            run_once(*registry.get(names[pick(rng)]));
+            if (std::round(output.back()) != std::round(input.back() * 2.0f)) {
+                ++failures;
+            }
+        }
+        double request_seconds = std::chrono::duration<double>(Clock::now() - begin).count();
+        ModelRegistryStats after = registry.stats();
+
+        std::cout << "\nRequests: " << num_requests << " in " << request_seconds * 1000.0 << " ms ("
+                  << (request_seconds > 0.0 ? num_requests / request_seconds : 0.0) << " req/s)" << std::endl;
+        std::cout << "Hits: " << after.hits - before.hits << ", loads: " << after.loads - before.loads
+                  << ", evictions: " << after.evictions - before.evictions << std::endl;
+        size_t rss = current_rss_bytes();
+        std::cout << "Loaded now: " << after.loaded << " of " << after.registered << " models, estimated "
+                  << to_mib(after.resident_bytes) << " MiB; process RSS " << to_mib(rss) << " MiB ("
+                  << to_mib(rss) - to_mib(base_rss) << " MiB since before the first model), threads "
+                  << current_thread_count() << std::endl;
+
+        // The budget is not part of the verdict: the registry evicts by its own
+        // estimates, so comparing them with the budget proves nothing, and RSS
+        // does not shrink reliably when a session is freed (the allocator keeps
+        // the pages), so the measured RSS above cannot be held to it either.
+        bool passed = failures == 0;
+        std::cout << "Test " << (passed ? "PASSED" : "FAILED") << std::endl;
+        if (!passed) {
+            return EXIT_FAILURE;
+        }
+
+    } catch (const Ort::Exception& ex) {
+        std::cerr << "ONNX Runtime Error: " << ex.what() << std::endl;
+        return EXIT_FAILURE;
+    } catch (const std::exception& ex) {
+        std::cerr << "Standard C++ Error: " << ex.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,319 @@
+#include <iostream> // For standard input/output operations (e.g., std::cout, std::cerr)
+#include <fstream>  // For copying the model file
+#include <vector>   // For std::vector to hold requests and samples
+#include <string>   // For std::string to handle paths and argument parsing
+#include <cstdio>   // For std::rename, std::remove
+#include <cstdlib>  // For EXIT_FAILURE/EXIT_SUCCESS, mkdtemp
+#include <cstring>  // For std::strcmp
+#include <chrono>   // For timing requests and reloads
+#include <thread>   // For the client threads
+#include <mutex>    // For collecting reload statistics
+#include <atomic>   // For the stop flag
+#include <memory>   // For std::shared_ptr sessions
+#include <cmath>    // For std::round
+#include <stdexcept> // For std::runtime_error
+
+// POSIX header for rmdir
+#include <unistd.h>
+
+// ONNX Runtime C++ API header file
+#include <onnxruntime_cxx_api.h>
+
+#include "hot_reload.h"
+#include "latency_stats.h"
+
+// Replaces the model file under load and checks that no request is dropped.
+//
+// The model is copied into a temporary directory and served by a
+// HotReloader<Ort::Session> that watches the copy. Client threads send
+// requests back to back while the main thread replaces the file (write a
+// temporary file, then rename it over the model) several times, alternating
+// between linear.onnx (y = 2x) and linear_x3.onnx (y = 3x), so every request
+// shows which model answered it. For every
+// reload the program reports how long it took from the rename until the new
+// session was serving (including the watcher's 100 ms settle time), how long
+// the swap itself took, and the worst request
+// latency while the reload was in progress compared with the p99 outside it.
+//
+// A request counts as dropped if it threw or returned neither 2x nor 3x, and
+// as stale if it started after a new model was serving but got the old one's
+// output. The run passes when no request was dropped or stale and every
+// replacement was picked up.
+//
+//   ./linear_reload --threads 4 --reloads 5 --interval-ms 300
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Sample {
+    double start_ms;   // Since the start of the run.
+    double latency_us;
+    int scale;         // 2 or 3: which model answered; 0: the request failed.
+};
+
+struct ReloadWindow {
+    double replaced_ms = 0.0; // When the file was renamed into place.
+    double serving_ms = -1.0; // When the new generation was observed (-1: never).
+    ReloadStats stats;
+};
+
+void copy_file(const std::string& from, const std::string& to) {
+    std::ifstream in(from, std::ios::binary);
+    std::ofstream out(to, std::ios::binary | std::ios::trunc);
+    if (!in || !out || !(out << in.rdbuf())) {
+        throw std::runtime_error("cannot copy " + from + " to " + to);
+    }
+}
+
+double ms_since(Clock::time_point begin) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - begin).count();
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::string source_model = "data/linear/linear.onnx";
+    std::string alternate_model = "data/linear/linear_x3.onnx";
+    int num_clients = 4;
+    int num_reloads = 5;
+    int interval_ms = 300;
+    size_t batch_size = 16;
+
+    try {
+        for (int i = 1; i < argc; ++i) {
+            if (std::strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+                num_clients = std::stoi(argv[++i]);
+            } else if (std::strcmp(argv[i], "--reloads") == 0 && i + 1 < argc) {
+                num_reloads = std::stoi(argv[++i]);
+            } else if (std::strcmp(argv[i], "--interval-ms") == 0 && i + 1 < argc) {
+                interval_ms = std::stoi(argv[++i]);
+            } else if (std::strcmp(argv[i], "--batch") == 0 && i + 1 < argc) {
+                batch_size = std::stoul(argv[++i]);
+            } else if (std::strcmp(argv[i], "--model") == 0 && i + 1 < argc) {
+                source_model = argv[++i];
+            } else if (std::strcmp(argv[i], "--alt-model") == 0 && i + 1 < argc) {
+                alternate_model = argv[++i];
+            } else {
+                throw std::invalid_argument(argv[i]);
+            }
+        }
+    } catch (const std::exception&) {
+        std::cerr << "Usage: " << argv[0] << " [--threads N] [--reloads N] [--interval-ms N] [--batch N]"
+                  << " [--model <y=2x model>] [--alt-model <y=3x model>]" << std::endl;
+        return EXIT_FAILURE;
+    }
+    if (num_clients <= 0 || num_reloads <= 0 || interval_ms <= 0 || batch_size == 0) {
+        std::cerr << "Error: --threads, --reloads, --interval-ms and --batch must be positive." << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    char directory_template[] = "/tmp/linear_reload_XXXXXX";
+    if (mkdtemp(directory_template) == nullptr) {
+        std::cerr << "Error: cannot create a temporary directory" << std::endl;
+        return EXIT_FAILURE;
+    }
+    const std::string directory = directory_template;
+    const std::string model_path = directory + "/linear.onnx";
+    const std::string staging_path = directory + "/linear.onnx.tmp";
+    int exit_code = EXIT_SUCCESS;
+
+    try {
+        {
+            std::ifstream alternate(alternate_model);
+            if (!alternate) {
+                throw std::runtime_error("cannot open " + alternate_model + " (run data/linear/linear.py to create it)");
+            }
+        }
+        copy_file(source_model, model_path);
+        Ort::Env env(ORT_LOGGING_LEVEL_WARNING, "linear_reload");
+        const char* input_name = "input";
+        const char* output_name = "output";
+
+        // --- 1. Loader: build the session and run it once before it is published ---
+        auto load_session = [&] {
+            auto session = std::make_shared<Ort::Session>(env, model_path.c_str(), Ort::SessionOptions());
+            std::vector<float> input(batch_size, 1.0f);
+            std::vector<float> output(batch_size);
+            int64_t shape[2] = {static_cast<int64_t>(batch_size), 1};
+            auto memory_info = Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
+            Ort::Value input_tensor = Ort::Value::CreateTensor<float>(memory_info, input.data(), batch_size, shape, 2);
+            Ort::Value output_tensor = Ort::Value::CreateTensor<float>(memory_info, output.data(), batch_size, shape, 2);
+            session->Run(Ort::RunOptions{nullptr}, &input_name, &input_tensor, 1, &output_name, &output_tensor, 1);
+            return session;
+        };
+        HotReloader<Ort::Session> sessions(load_session);
+
+        std::mutex reload_mutex;
+        std::vector<ReloadStats> reload_stats;
+        sessions.on_reload([&](const ReloadStats& stats) {
+            std::lock_guard<std::mutex> lock(reload_mutex);
+            reload_stats.push_back(stats);
+        });
+        sessions.watch(model_path);
+
+        // --- 2. Clients: back-to-back requests, each on the session current when it starts ---
+        auto run_begin = Clock::now();
+        std::atomic<bool> stop{false};
+        std::vector<std::vector<Sample>> samples(num_clients);
+        std::vector<size_t> dropped(num_clients, 0);
+        std::vector<std::thread> clients;
+        for (int c = 0; c < num_clients; ++c) {
+            clients.emplace_back([&, c] {
+                auto memory_info = Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
+                std::vector<float> input(batch_size);
+                std::vector<float> output(batch_size);
+                int64_t shape[2] = {static_cast<int64_t>(batch_size), 1};
+                for (size_t r = 0; !stop.load(std::memory_order_relaxed); ++r) {
+                    for (size_t i = 0; i < batch_size; ++i) {
+                        input[i] = static_cast<float>(1 + (r + i) % 100); // Never 0, so 2x and 3x differ.
+                    }
+                    double start_ms = ms_since(run_begin);
+                    auto request_begin = Clock::now();
+                    int scale = 0;
+                    try {
+                        std::shared_ptr<Ort::Session> session = sessions.current();
+                        Ort::Value input_tensor = Ort::Value::CreateTensor<float>(
+                            memory_info, input.data(), batch_size, shape, 2);
+                        Ort::Value output_tensor = Ort::Value::CreateTensor<float>(
+                            memory_info, output.data(), batch_size, shape, 2);
+                        session->Run(Ort::RunOptions{nullptr}, &input_name, &input_tensor, 1,
+                                     &output_name, &output_tensor, 1);
+                        scale = std::round(output[0]) == std::round(input[0] * 3.0f) ? 3 : 2;
+                        for (size_t i = 0; i < batch_size && scale != 0; ++i) {
+                            if (std::round(output[i]) != std::round(input[i] * scale)) {
+                                scale = 0;
+                            }
+                        }
+                    } catch (const std::exception&) {
+                        scale = 0;
+                    }
+                    double latency_us = std::chrono::duration<double, std::micro>(Clock::now() - request_begin).count();
+                    samples[c].push_back({start_ms, latency_us, scale});
+                    dropped[c] += scale == 0 ? 1 : 0;
+                }
+            });
+        }
+
+        // --- 3. Replace the model file num_reloads times, alternating between 3x and 2x ---
+        std::vector<ReloadWindow> windows(num_reloads);
+        try {
+            for (int k = 0; k < num_reloads; ++k) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(interval_ms));
+                uint64_t expected_generation = sessions.generation() + 1;
+                copy_file(k % 2 == 0 ? alternate_model : source_model, staging_path);
+                if (std::rename(staging_path.c_str(), model_path.c_str()) != 0) {
+                    throw std::runtime_error("cannot rename " + staging_path + " over " + model_path);
+                }
+                windows[k].replaced_ms = ms_since(run_begin);
+                auto wait_begin = Clock::now();
+                while (sessions.generation() < expected_generation && ms_since(wait_begin) < 10000.0) {
+                    std::this_thread::sleep_for(std::chrono::microseconds(200));
+                }
+                if (sessions.generation() >= expected_generation) {
+                    windows[k].serving_ms = ms_since(run_begin);
+                }
+            }
+        } catch (...) {
+            stop = true; // Let the clients finish before the error propagates.
+            for (auto& client : clients) {
+                client.join();
+            }
+            throw;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(interval_ms));
+        stop = true;
+        for (auto& client : clients) {
+            client.join();
+        }
+        sessions.stop();
+        sessions.wait_retired(); // The last reload's stats arrive once its old session is freed.
+        double wall_seconds = ms_since(run_begin) / 1000.0;
+
+        // --- 4. Split request latencies into "during a reload" and "steady state" ---
+        {
+            std::lock_guard<std::mutex> lock(reload_mutex);
+            for (size_t k = 0; k < windows.size() && k < reload_stats.size(); ++k) {
+                windows[k].stats = reload_stats[k];
+            }
+        }
+        LatencyStats all;
+        LatencyStats steady;
+        LatencyStats during_reload;
+        size_t total_dropped = 0;
+        size_t stale = 0;
+        for (int c = 0; c < num_clients; ++c) {
+            total_dropped += dropped[c];
+            for (const Sample& sample : samples[c]) {
+                all.add(sample.latency_us);
+                // The model serving when the request started: 2x at first, then
+                // 3x after odd-numbered reloads and 2x after even-numbered ones.
+                int expected_scale = 2;
+                bool known = true;
+                for (int k = 0; k < num_reloads; ++k) {
+                    if (sample.start_ms < windows[k].replaced_ms) {
+                        break;
+                    }
+                    expected_scale = k % 2 == 0 ? 3 : 2;
+                    // Between rename and the observed swap either model may answer.
+                    known = windows[k].serving_ms >= 0.0 && sample.start_ms >= windows[k].serving_ms;
+                }
+                if (known && sample.scale != 0 && sample.scale != expected_scale) {
+                    ++stale;
+                }
+                bool in_window = false;
+                for (const ReloadWindow& window : windows) {
+                    double end_ms = window.serving_ms < 0.0 ? window.replaced_ms : window.serving_ms;
+                    // A request overlaps the reload if it ran at any point between rename and swap.
+                    if (sample.start_ms <= end_ms && sample.start_ms + sample.latency_us / 1000.0 >= window.replaced_ms) {
+                        in_window = true;
+                        break;
+                    }
+                }
+                (in_window ? during_reload : steady).add(sample.latency_us);
+            }
+        }
+
+        std::cout << "Clients: " << num_clients << ", batch: " << batch_size << ", reloads: " << num_reloads
+                  << ", model copy: " << model_path << std::endl;
+        std::cout << "\n--- Reloads ---" << std::endl;
+        int missed = 0;
+        for (int k = 0; k < num_reloads; ++k) {
+            const ReloadWindow& window = windows[k];
+            if (window.serving_ms < 0.0 || !window.stats.ok) {
+                ++missed;
+                std::cout << "#" << k + 1 << ": not picked up"
+                          << (window.stats.error.empty() ? "" : " (" + window.stats.error + ")") << std::endl;
+                continue;
+            }
+            std::cout << "#" << k + 1 << ": serving after " << window.serving_ms - window.replaced_ms
+                      << " ms (load + warm-up " << window.stats.load_ms << " ms, swap " << window.stats.swap_us
+                      << " us, old session retired after " << window.stats.retire_ms << " ms)" << std::endl;
+        }
+
+        std::cout << "\n--- All requests ---" << std::endl;
+        all.print(std::cout, wall_seconds);
+        std::cout << "Latency max: " << all.percentile(100) << " us" << std::endl;
+        std::cout << "\nSteady state p99: " << steady.percentile(99) << " us (" << steady.count() << " requests)"
+                  << "\nDuring reloads p99: " << during_reload.percentile(99) << " us, max: "
+                  << during_reload.percentile(100) << " us (" << during_reload.count() << " requests)" << std::endl;
+        std::cout << "Dropped requests: " << total_dropped << ", stale requests: " << stale
+                  << ", missed reloads: " << missed << std::endl;
+
+        bool passed = total_dropped == 0 && stale == 0 && missed == 0;
+        std::cout << "Test " << (passed ? "PASSED" : "FAILED") << std::endl;
+        exit_code = passed ? EXIT_SUCCESS : EXIT_FAILURE;
+
+    } catch (const Ort::Exception& ex) {
+        std::cerr << "ONNX Runtime Error: " << ex.what() << std::endl;
+        exit_code = EXIT_FAILURE;
+    } catch (const std::exception& ex) {
+        std::cerr << "Standard C++ Error: " << ex.what() << std::endl;
+        exit_code = EXIT_FAILURE;
+    }
+
+    std::remove(staging_path.c_str());
+    std::remove(model_path.c_str());
+    ::rmdir(directory.c_str());
+    return exit_code;
+}
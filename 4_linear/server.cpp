@@ -0,0 +1,515 @@
+#include <iostream> // For standard input/output operations (e.g., std::cout, std::cerr)
+#include <vector>   // For std::vector to hold input/output data
+#include <string>   // For std::string to handle names and argument parsing
+#include <cstdlib>  // For std::strtof and EXIT_FAILURE/EXIT_SUCCESS
+#include <cstring>  // For std::strcmp, std::memset
+#include <chrono>   // For measuring per-request latency
+#include <csignal>  // For SIGINT/SIGTERM handling
+#include <cerrno>   // For errno
+#include <utility>  // For std::move
+#include <memory>   // For std::shared_ptr models
+#include <algorithm> // For std::max
+
+// POSIX headers for poll(), non-blocking Unix-domain sockets and stat()
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/stat.h>
+
+// ONNX Runtime C++ API header file
+#include <onnxruntime_cxx_api.h>
+
+#include "hot_reload.h"
+#include "metrics.h"
+#include "model_cache.h"
+#include "provider_config.h"
+#include "result_cache.h"
+
+// Long-lived inference server for the linear model.
+//
+// Unlike linear/linear2/linear3, which build an Ort::Env and Ort::Session for
+// every prediction, this program loads the model once and then answers
+// requests until its input is closed (stdin mode) or it receives SIGINT/SIGTERM
+// (socket mode). Each request is a single line containing one number, and each
+// reply is a single line containing the model output.
+//
+//   stdin mode:  printf '1\n2\n3\n' | ./linear_server
+//   socket mode: ./linear_server --socket /tmp/linear.sock
+//                printf '3\n' | nc -U /tmp/linear.sock
+//
+// With --cache-dir, the graph-optimized model is saved on the first start and
+// loaded directly on later starts (see model_cache.h). With --ep-config, the
+// execution provider chosen by `available_providers --save` is used. With
+// --watch, rewriting or replacing the model file loads the new model in the
+// background and swaps it in between requests (see hot_reload.h). With
+// --metrics-file, per-stage latency histograms and request counters are
+// written to that file in the Prometheus text format (see metrics.h). With
+// --cache N, up to N predictions are memoized (see result_cache.h), so a
+// repeated input is answered without running the model.
+
+namespace {
+
+volatile std::sig_atomic_t g_stop_requested = 0;
+
+void handle_stop_signal(int) {
+    g_stop_requested = 1;
+}
+
+using Clock = std::chrono::steady_clock;
+
+// Server metrics, exported with --metrics-file.
+struct ServerMetrics {
+    MetricHistogram session_create = Metrics::global().histogram(
+        "linear_server_session_create_seconds", "Time to create (or load from the cache) the model session");
+    MetricHistogram tensor_create = Metrics::global().histogram(
+        "linear_server_tensor_create_seconds", "Time to wrap the request's input and output tensors");
+    MetricHistogram run = Metrics::global().histogram(
+        "linear_server_run_seconds", "Time spent in Session::Run");
+    MetricHistogram request = Metrics::global().histogram(
+        "linear_server_request_seconds", "Time from parsing a request line to queuing its reply");
+    MetricCounter requests = Metrics::global().counter(
+        "linear_server_requests_total", "Request lines answered");
+    MetricCounter errors = Metrics::global().counter(
+        "linear_server_request_errors_total", "Request lines that were not a valid number");
+};
+
+const ServerMetrics& server_metrics() {
+    static const ServerMetrics metrics;
+    return metrics;
+}
+
+// True if both paths name the same existing file (by device and inode, so
+// "./data/x.onnx" and "data/x.onnx" match).
+bool same_file(const std::string& a, const std::string& b) {
+    struct stat info_a;
+    struct stat info_b;
+    return ::stat(a.c_str(), &info_a) == 0 && ::stat(b.c_str(), &info_b) == 0 &&
+           info_a.st_dev == info_b.st_dev && info_a.st_ino == info_b.st_ino;
+}
+
+// Holds the session and the pre-built tensor plumbing that every request reuses.
+//
+// The optional result cache belongs to the model, so a reloaded model starts
+// with an empty cache and never answers with the previous model's results.
+class LinearModel {
+public:
+    LinearModel(Ort::Session session, size_t cache_entries)
+        : session_(std::move(session)),
+          memory_info_(Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault)) {
+        if (cache_entries > 0) {
+            ResultCacheOptions cache_options;
+            cache_options.max_entries = cache_entries;
+            cache_options.max_bytes = 0; // Bounded by the entry count only.
+            cache_ = std::make_unique<ResultCache>(cache_options);
+        }
+    }
+
+    float predict(float input_value) {
+        if (!cache_) {
+            return run(input_value);
+        }
+        Span<const float> input(&input_value, 1);
+        uint64_t input_hash = ResultCache::hash(input);
+        float output_value;
+        if (!cache_->lookup(input_hash, input, Span<float>(&output_value, 1))) {
+            output_value = run(input_value);
+            cache_->insert(input_hash, input, Span<const float>(&output_value, 1));
+        }
+        return output_value;
+    }
+
+    void warm_up() { run(0.0f); }
+
+    // Null when the server runs without --cache.
+    const ResultCache* cache() const { return cache_.get(); }
+
+private:
+    float run(float input_value) {
+        const ServerMetrics& metrics = server_metrics();
+        StageTimer stages;
+        input_value_ = input_value;
+        Ort::Value input_tensor = Ort::Value::CreateTensor<float>(
+            memory_info_, &input_value_, 1, input_shape_, 2);
+        Ort::Value output_tensor = Ort::Value::CreateTensor<float>(
+            memory_info_, &output_value_, 1, input_shape_, 2);
+        stages.lap(metrics.tensor_create);
+
+        const char* input_name = "input";
+        const char* output_name = "output";
+        // Write straight into output_value_ instead of letting Run allocate a tensor.
+        session_.Run(Ort::RunOptions{nullptr},
+                     &input_name, &input_tensor, 1,
+                     &output_name, &output_tensor, 1);
+        stages.lap(metrics.run);
+        return output_value_;
+    }
+
+    Ort::Session session_;
+    Ort::MemoryInfo memory_info_;
+    std::unique_ptr<ResultCache> cache_;
+    int64_t input_shape_[2] = {1, 1};
+    float input_value_ = 0.0f;
+    float output_value_ = 0.0f;
+};
+
+// Longest request line accepted; a client that sends more without a newline is dropped.
+constexpr size_t kMaxLineBytes = 1024;
+// Replies queued for a client that is not reading them. Above this, its input
+// is left unread (so no more replies are produced) until it catches up.
+constexpr size_t kMaxQueuedReplyBytes = 64 * 1024;
+
+// A connected client (or stdin/stdout) with its partially received line and
+// the replies not yet written.
+struct Connection {
+    int read_fd;
+    int write_fd;
+    std::string pending;
+    std::string replies;
+    bool input_closed = false;
+};
+
+// Answers every complete line in conn.pending, queues the replies and keeps
+// the trailing partial line. Returns false if that line is longer than kMaxLineBytes.
+bool serve_lines(Connection& conn, HotReloader<LinearModel>& models, HistogramSnapshot& latencies) {
+    size_t start = 0;
+    size_t newline;
+    while ((newline = conn.pending.find('\n', start)) != std::string::npos) {
+        std::string line = conn.pending.substr(start, newline - start);
+        start = newline + 1;
+        if (line.empty() || line == "\r") {
+            continue;
+        }
+
+        auto begin = Clock::now();
+        char* end = nullptr;
+        float input_value = std::strtof(line.c_str(), &end);
+        if (line.size() > kMaxLineBytes) {
+            conn.replies += "error: line too long\n";
+            server_metrics().errors.add();
+        } else if (end == line.c_str()) {
+            conn.replies += "error: invalid number\n";
+            server_metrics().errors.add();
+        } else {
+            // Each request runs on whichever model is current when it starts.
+            std::shared_ptr<LinearModel> model = models.current();
+            conn.replies += std::to_string(model->predict(input_value)) + "\n";
+        }
+        auto elapsed = Clock::now() - begin;
+        latencies.add_ns(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+        server_metrics().request.record(elapsed);
+        server_metrics().requests.add();
+    }
+    conn.pending.erase(0, start);
+    return conn.pending.size() <= kMaxLineBytes;
+}
+
+// Reads whatever is available on conn.read_fd and serves it; at EOF also
+// serves a last line without a newline and sets conn.input_closed. Returns
+// false if the connection must be dropped (read error or overlong line).
+bool pump_input(Connection& conn, HotReloader<LinearModel>& models, HistogramSnapshot& latencies) {
+    char buffer[4096];
+    ssize_t received = ::read(conn.read_fd, buffer, sizeof(buffer));
+    if (received < 0 && (errno == EINTR || errno == EAGAIN || errno == EWOULDBLOCK)) {
+        return true;
+    }
+    if (received < 0) {
+        return false;
+    }
+    if (received == 0) {
+        conn.input_closed = true;
+        if (!conn.pending.empty()) {
+            conn.pending.push_back('\n');
+            return serve_lines(conn, models, latencies);
+        }
+        return true;
+    }
+    conn.pending.append(buffer, static_cast<size_t>(received));
+    return serve_lines(conn, models, latencies);
+}
+
+// Writes as much of conn.replies as the descriptor takes without blocking
+// (all of it, for a blocking descriptor). Returns false on a write error,
+// e.g. when the client went away.
+bool flush_replies(Connection& conn) {
+    size_t written_total = 0;
+    while (written_total < conn.replies.size()) {
+        ssize_t written = ::write(conn.write_fd, conn.replies.data() + written_total,
+                                  conn.replies.size() - written_total);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                break; // The socket buffer is full; poll() says when to continue.
+            }
+            return false;
+        }
+        written_total += static_cast<size_t>(written);
+    }
+    conn.replies.erase(0, written_total);
+    return true;
+}
+
+int open_listen_socket(const std::string& path) {
+    int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) {
+        return -1;
+    }
+    sockaddr_un addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(addr.sun_path)) {
+        ::close(fd);
+        errno = ENAMETOOLONG;
+        return -1;
+    }
+    std::strcpy(addr.sun_path, path.c_str());
+    ::unlink(path.c_str()); // Remove a stale socket left by a previous run.
+    if (::bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0 || ::listen(fd, 64) < 0) {
+        ::close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+// Event loop over the listening socket and all connected clients. Client
+// sockets are non-blocking, so a client that stops reading only stalls itself.
+void serve_socket(int listen_fd, HotReloader<LinearModel>& models, HistogramSnapshot& latencies) {
+    std::vector<Connection> connections;
+    std::vector<pollfd> fds;
+    while (!g_stop_requested) {
+        fds.clear();
+        fds.push_back({listen_fd, POLLIN, 0});
+        for (const auto& conn : connections) {
+            short events = 0;
+            if (!conn.input_closed && conn.replies.size() < kMaxQueuedReplyBytes) {
+                events |= POLLIN;
+            }
+            if (!conn.replies.empty()) {
+                events |= POLLOUT;
+            }
+            fds.push_back({conn.read_fd, events, 0});
+        }
+        if (::poll(fds.data(), fds.size(), -1) < 0) {
+            continue; // EINTR: re-check the stop flag.
+        }
+
+        // Walk the clients backwards so erasing does not shift unvisited entries.
+        for (size_t i = connections.size(); i-- > 0;) {
+            short revents = fds[i + 1].revents;
+            if (revents == 0) {
+                continue;
+            }
+            Connection& conn = connections[i];
+            bool keep = true;
+            if ((revents & (POLLIN | POLLHUP | POLLERR)) && !conn.input_closed) {
+                keep = pump_input(conn, models, latencies);
+            }
+            if (keep && !conn.replies.empty()) {
+                keep = flush_replies(conn);
+            }
+            if (!keep || (conn.input_closed && conn.replies.empty())) {
+                ::close(conn.read_fd);
+                connections.erase(connections.begin() + i);
+            }
+        }
+
+        if (fds[0].revents & POLLIN) {
+            int client_fd = ::accept(listen_fd, nullptr, nullptr);
+            if (client_fd >= 0) {
+                ::fcntl(client_fd, F_SETFL, ::fcntl(client_fd, F_GETFL) | O_NONBLOCK);
+                connections.push_back({client_fd, client_fd, std::string(), std::string()});
+            }
+        }
+    }
+    for (const auto& conn : connections) {
+        ::close(conn.read_fd);
+    }
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::string model_path = "data/linear/linear.onnx";
+    std::string socket_path;
+    ModelCacheOptions cache_options;
+    std::string ep_config_path;
+    bool watch_model = false;
+    std::string metrics_path;
+    int metrics_interval_ms = 5000;
+    size_t cache_entries = 0;
+
+    try {
+        for (int i = 1; i < argc; ++i) {
+            if (std::strcmp(argv[i], "--socket") == 0 && i + 1 < argc) {
+                socket_path = argv[++i];
+            } else if (std::strcmp(argv[i], "--model") == 0 && i + 1 < argc) {
+                model_path = argv[++i];
+            } else if (std::strcmp(argv[i], "--opt-level") == 0 && i + 1 < argc) {
+                cache_options.optimization_level = parse_optimization_level(argv[++i]);
+            } else if (std::strcmp(argv[i], "--cache-dir") == 0 && i + 1 < argc) {
+                cache_options.cache_dir = argv[++i];
+            } else if (std::strcmp(argv[i], "--ort-format") == 0) {
+                cache_options.ort_format = true;
+            } else if (std::strcmp(argv[i], "--ep-config") == 0 && i + 1 < argc) {
+                ep_config_path = argv[++i];
+            } else if (std::strcmp(argv[i], "--watch") == 0) {
+                watch_model = true;
+            } else if (std::strcmp(argv[i], "--metrics-file") == 0 && i + 1 < argc) {
+                metrics_path = argv[++i];
+            } else if (std::strcmp(argv[i], "--metrics-interval-ms") == 0 && i + 1 < argc) {
+                metrics_interval_ms = std::stoi(argv[++i]);
+            } else if (std::strcmp(argv[i], "--cache") == 0 && i + 1 < argc) {
+                cache_entries = std::stoul(argv[++i]);
+            } else {
+                throw std::invalid_argument(argv[i]);
+            }
+        }
+    } catch (const std::exception&) {
+        std::cerr << "Usage: " << argv[0] << " [--model <model_path>] [--socket <socket_path>]"
+                  << " [--opt-level disable|basic|extended|all] [--cache-dir <dir>] [--ort-format]"
+                  << " [--ep-config <file>] [--watch] [--metrics-file <file>] [--metrics-interval-ms N]"
+                  << " [--cache N]" << std::endl;
+        std::cerr << "Reads one number per line from stdin (or from each socket client)" << std::endl;
+        std::cerr << "and replies with one prediction per line." << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // Install the handlers without SA_RESTART so poll() returns on a signal.
+    struct sigaction action;
+    std::memset(&action, 0, sizeof(action));
+    action.sa_handler = handle_stop_signal;
+    sigaction(SIGINT, &action, nullptr);
+    sigaction(SIGTERM, &action, nullptr);
+    // A client closing its socket mid-reply must not kill the server.
+    std::signal(SIGPIPE, SIG_IGN);
+
+    // Metrics are off by default; only record them when something exports them.
+    Metrics::global().set_enabled(!metrics_path.empty());
+
+    try {
+        // --- 1. Load the model once ---
+        auto startup_begin = Clock::now();
+        Ort::Env env(ORT_LOGGING_LEVEL_WARNING, "linear_server");
+        Ort::SessionOptions session_options;
+        if (!ep_config_path.empty()) {
+            ProviderConfig provider_config = load_provider_config(ep_config_path);
+            if (!same_file(provider_config.model, model_path)) {
+                std::cerr << "Warning: " << ep_config_path << " was saved for " << provider_config.model
+                          << ", not " << model_path << "; its provider choice may not suit this model" << std::endl;
+            }
+            append_provider(session_options, provider_config.provider);
+            cache_options.providers.push_back(provider_config.provider); // A CPU-optimized model must not be reused under another provider.
+            std::cerr << "Using execution provider " << provider_config.provider
+                      << " (chosen for batch size " << provider_config.batch_size << ")" << std::endl;
+        }
+        ModelCacheResult cache_result;
+        double load_ms = 0.0;
+        // Used for the first model and, with --watch, for every reload.
+        auto load_model = [&] {
+            auto load_begin = Clock::now();
+            std::shared_ptr<LinearModel> model;
+            {
+                ScopedTimer timer(server_metrics().session_create);
+                model = std::make_shared<LinearModel>(
+                    create_cached_session(env, model_path, session_options, cache_options, &cache_result),
+                    cache_entries);
+            }
+            load_ms = std::chrono::duration<double, std::milli>(Clock::now() - load_begin).count();
+            // The first Run finishes allocation planning, so do it before taking traffic.
+            // (Bypassing the cache, so its hit rate only reflects real requests.)
+            model->warm_up();
+            return model;
+        };
+        HotReloader<LinearModel> models(load_model);
+        double startup_ms = std::chrono::duration<double, std::milli>(Clock::now() - startup_begin).count();
+        std::cerr << "Model loaded from " << cache_result.loaded_path
+                  << (cache_options.cache_dir.empty() ? "" : cache_result.cache_hit ? " (cache hit)" : " (cache miss)")
+                  << " in " << load_ms << " ms, ready after " << startup_ms << " ms" << std::endl;
+
+        if (watch_model) {
+            models.on_reload([&](const ReloadStats& reload) {
+                if (reload.ok) {
+                    std::cerr << "Reloaded " << model_path << " (generation " << reload.generation << "): loaded in "
+                              << reload.load_ms << " ms, swapped in " << reload.swap_us << " us, old model retired after "
+                              << reload.retire_ms << " ms" << std::endl;
+                } else {
+                    std::cerr << "Reload of " << model_path << " failed, still serving generation "
+                              << reload.generation << ": " << reload.error << std::endl;
+                }
+            });
+            models.watch(model_path);
+            std::cerr << "Watching " << model_path << " for changes" << std::endl;
+        }
+
+        // --- 2. Serve requests ---
+        std::unique_ptr<MetricsDumper> metrics_dumper;
+        if (!metrics_path.empty()) {
+            metrics_dumper = std::make_unique<MetricsDumper>(metrics_path, std::max(100, metrics_interval_ms));
+            std::cerr << "Writing metrics to " << metrics_path << " every " << std::max(100, metrics_interval_ms)
+                      << " ms" << std::endl;
+        }
+        // Fixed-size log-linear buckets (metrics.h), so a long-running server
+        // does not keep one sample per request.
+        HistogramSnapshot latencies;
+        auto serve_begin = Clock::now();
+
+        if (socket_path.empty()) {
+            // stdin/stdout stay blocking: there is only one client to wait for.
+            Connection conn{STDIN_FILENO, STDOUT_FILENO, std::string(), std::string()};
+            while (!g_stop_requested && !conn.input_closed) {
+                if (!pump_input(conn, models, latencies)) {
+                    std::cerr << "Error: request line longer than " << kMaxLineBytes << " bytes" << std::endl;
+                    break;
+                }
+                if (!flush_replies(conn)) {
+                    break;
+                }
+            }
+            flush_replies(conn);
+        } else {
+            int listen_fd = open_listen_socket(socket_path);
+            if (listen_fd < 0) {
+                std::cerr << "Error: cannot listen on " << socket_path << ": " << std::strerror(errno) << std::endl;
+                return EXIT_FAILURE;
+            }
+            std::cerr << "Listening on " << socket_path << " (Ctrl+C to stop)" << std::endl;
+            serve_socket(listen_fd, models, latencies);
+            ::close(listen_fd);
+            ::unlink(socket_path.c_str());
+        }
+
+        // --- 3. Report latency and throughput ---
+        double wall_seconds = std::chrono::duration<double>(Clock::now() - serve_begin).count();
+        std::cerr << "--- Server statistics ---" << std::endl;
+        // Percentiles are bucket upper bounds, at most 6.25% above the true value.
+        std::cerr << "Requests: " << latencies.count << std::endl;
+        std::cerr << "Latency mean: " << latencies.mean_ns() / 1000.0 << " us" << std::endl;
+        std::cerr << "Latency p50: " << latencies.percentile_ns(50) / 1000.0 << " us" << std::endl;
+        std::cerr << "Latency p99: " << latencies.percentile_ns(99) / 1000.0 << " us" << std::endl;
+        if (wall_seconds > 0.0) {
+            std::cerr << "Throughput: " << latencies.count / wall_seconds << " req/s" << std::endl;
+        }
+        if (const ResultCache* cache = models.current()->cache()) {
+            ResultCacheStats cache_stats = cache->stats();
+            std::cerr << "Result cache: " << cache_stats.hit_rate() * 100.0 << "% hits (" << cache_stats.hits
+                      << " hits, " << cache_stats.misses << " misses), " << cache_stats.entries << " entries, "
+                      << cache_stats.evictions << " evictions";
+            if (watch_model) {
+                std::cerr << " (current model generation only)";
+            }
+            std::cerr << std::endl;
+        }
+
+    } catch (const Ort::Exception& ex) {
+        std::cerr << "ONNX Runtime Error: " << ex.what() << std::endl;
+        return EXIT_FAILURE;
+    } catch (const std::exception& ex) {
+        std::cerr << "Standard C++ Error: " << ex.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
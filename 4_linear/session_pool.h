@@ -0,0 +1,206 @@
+#pragma once
+
+#include <algorithm>          // For std::find
+#include <condition_variable> // For waiting on a free runner
+#include <memory>             // For std::unique_ptr
+#include <mutex>              // For protecting the free list
+#include <stdexcept>          // For std::invalid_argument, std::out_of_range
+#include <string>             // For std::to_string
+#include <thread>             // For std::thread::hardware_concurrency
+#include <vector>             // For the sessions and the free list
+
+#ifdef __linux__
+#include <pthread.h> // For pthread_setaffinity_np
+#include <sched.h>   // For cpu_set_t
+#endif
+
+// ONNX Runtime C++ API header file
+#include <onnxruntime_cxx_api.h>
+
+// Threading configuration for SessionPool.
+//
+// With per-session threads (the default), each session owns intra_op_threads
+// intra-op threads, so N sessions use N * intra_op_threads threads in total.
+// With use_global_thread_pool, the Env owns one intra-op and one inter-op pool
+// sized by intra_op_threads/inter_op_threads and every session shares them,
+// which keeps the thread count fixed no matter how many sessions exist.
+struct SessionPoolOptions {
+    size_t num_runners = 1;        // How many callers can run at the same time.
+    bool share_session = false;    // One session shared by all runners instead of one per runner.
+    int intra_op_threads = 1;      // Threads used inside one operator (0 = ORT default).
+    int inter_op_threads = 1;      // Threads used across operators in parallel mode (0 = ORT default).
+    bool parallel_execution = false; // ORT_PARALLEL instead of ORT_SEQUENTIAL; needed for inter-op threads.
+    bool allow_spinning = true;    // Let idle ORT threads spin instead of sleeping.
+    bool use_global_thread_pool = false;
+    bool pin_to_cores = false;     // Pin runner i's calling thread to core i (see pin_current_thread).
+    GraphOptimizationLevel optimization_level = ORT_ENABLE_ALL;
+
+    // One CPU arena registered on the Env and shared by every session, instead of
+    // one arena per session. The arena settings are only used with it; -1 keeps
+    // ORT's default for that setting.
+    bool use_env_allocator = false;
+    size_t arena_max_bytes = 0;              // 0 = no limit.
+    int arena_extend_strategy = -1;          // 0 = next power of two, 1 = exactly what is requested.
+    int arena_initial_chunk_bytes = -1;      // Size of the first chunk the arena reserves.
+    int arena_max_dead_bytes_per_chunk = -1; // Unused bytes tolerated before a chunk is split.
+};
+
+// A set of sessions for one model that callers lease one at a time.
+//
+// Ort::Session::Run is thread-safe, so sharing a single session between runners
+// works, but independent sessions avoid contention on the session's internal
+// state and allow each runner to be pinned to its own core. Both layouts are
+// available through SessionPoolOptions::share_session.
+class SessionPool {
+public:
+    // Exclusive use of one runner slot until the lease is destroyed.
+    class Lease {
+    public:
+        Lease(SessionPool& pool, size_t runner) : pool_(&pool), runner_(runner) {}
+        Lease(Lease&& other) noexcept : pool_(other.pool_), runner_(other.runner_) { other.pool_ = nullptr; }
+        Lease(const Lease&) = delete;
+        Lease& operator=(const Lease&) = delete;
+        Lease& operator=(Lease&&) = delete;
+        ~Lease() {
+            if (pool_ != nullptr) {
+                pool_->release(runner_);
+            }
+        }
+
+        Ort::Session& session() { return pool_->session_for(runner_); }
+        size_t runner() const { return runner_; }
+
+    private:
+        SessionPool* pool_;
+        size_t runner_;
+    };
+
+    SessionPool(const char* model_path, const SessionPoolOptions& options)
+        : options_(options) {
+        if (options_.num_runners == 0) {
+            throw std::invalid_argument("SessionPool needs at least one runner");
+        }
+
+        // --- Environment: optionally owns the global thread pools ---
+        if (options_.use_global_thread_pool) {
+            Ort::ThreadingOptions threading_options;
+            threading_options.SetGlobalIntraOpNumThreads(options_.intra_op_threads);
+            threading_options.SetGlobalInterOpNumThreads(options_.inter_op_threads);
+            threading_options.SetGlobalSpinControl(options_.allow_spinning ? 1 : 0);
+            env_ = std::make_unique<Ort::Env>(threading_options, ORT_LOGGING_LEVEL_WARNING, "session_pool");
+        } else {
+            env_ = std::make_unique<Ort::Env>(ORT_LOGGING_LEVEL_WARNING, "session_pool");
+        }
+
+        // --- Optional shared arena: every session allocates from one Env-level CPU arena ---
+        if (options_.use_env_allocator) {
+            Ort::MemoryInfo memory_info("Cpu", OrtArenaAllocator, 0, OrtMemTypeDefault);
+            Ort::ArenaCfg arena_cfg(options_.arena_max_bytes, options_.arena_extend_strategy,
+                                    options_.arena_initial_chunk_bytes, options_.arena_max_dead_bytes_per_chunk);
+            env_->CreateAndRegisterAllocator(memory_info, arena_cfg);
+        }
+
+        // --- Session options shared by every session in the pool ---
+        Ort::SessionOptions session_options;
+        session_options.SetGraphOptimizationLevel(options_.optimization_level);
+        session_options.SetExecutionMode(options_.parallel_execution ? ORT_PARALLEL : ORT_SEQUENTIAL);
+        if (options_.use_global_thread_pool) {
+            session_options.DisablePerSessionThreads();
+        } else {
+            session_options.SetIntraOpNumThreads(options_.intra_op_threads);
+            session_options.SetInterOpNumThreads(options_.inter_op_threads);
+            const char* spinning = options_.allow_spinning ? "1" : "0";
+            session_options.AddConfigEntry("session.intra_op.allow_spinning", spinning);
+            session_options.AddConfigEntry("session.inter_op.allow_spinning", spinning);
+        }
+        if (options_.use_env_allocator) {
+            session_options.AddConfigEntry("session.use_env_allocators", "1");
+        }
+
+        size_t num_sessions = options_.share_session ? 1 : options_.num_runners;
+        sessions_.reserve(num_sessions);
+        for (size_t i = 0; i < num_sessions; ++i) {
+            sessions_.push_back(std::make_unique<Ort::Session>(*env_, model_path, session_options));
+        }
+
+        free_runners_.reserve(options_.num_runners);
+        for (size_t i = options_.num_runners; i-- > 0;) {
+            free_runners_.push_back(i);
+        }
+    }
+
+    SessionPool(const SessionPool&) = delete;
+    SessionPool& operator=(const SessionPool&) = delete;
+
+    // Blocks until a runner is free and leases it.
+    Lease acquire() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cv_.wait(lock, [this] { return !free_runners_.empty(); });
+        size_t runner = free_runners_.back();
+        free_runners_.pop_back();
+        return Lease(*this, runner);
+    }
+
+    // Leases a specific runner, e.g. the one belonging to the calling worker thread.
+    // Throws std::out_of_range if there is no such runner.
+    Lease acquire(size_t runner) {
+        if (runner >= num_runners()) {
+            throw std::out_of_range("SessionPool::acquire: no runner " + std::to_string(runner));
+        }
+        std::unique_lock<std::mutex> lock(mutex_);
+        auto it = free_runners_.end();
+        cv_.wait(lock, [&] {
+            it = std::find(free_runners_.begin(), free_runners_.end(), runner);
+            return it != free_runners_.end();
+        });
+        free_runners_.erase(it);
+        return Lease(*this, runner);
+    }
+
+    Ort::Env& env() { return *env_; }
+    const SessionPoolOptions& options() const { return options_; }
+    size_t num_runners() const { return options_.num_runners; }
+    size_t num_sessions() const { return sessions_.size(); }
+
+    // Pins the calling thread to one core (modulo the number of cores).
+    // Runner threads call this with their runner index when pin_to_cores is set.
+    // Only the caller is pinned: ORT's own intra-op/inter-op threads keep the
+    // default affinity, so with intra_op_threads > 1 a runner's work still
+    // spreads over other cores. Returns false if pinning is not supported or failed.
+    static bool pin_current_thread(size_t core) {
+#ifdef __linux__
+        unsigned cores = std::thread::hardware_concurrency();
+        if (cores == 0) {
+            return false;
+        }
+        cpu_set_t cpu_set;
+        CPU_ZERO(&cpu_set);
+        CPU_SET(core % cores, &cpu_set);
+        return pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set) == 0;
+#else
+        (void)core;
+        return false;
+#endif
+    }
+
+private:
+    Ort::Session& session_for(size_t runner) {
+        return *sessions_[options_.share_session ? 0 : runner];
+    }
+
+    void release(size_t runner) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            free_runners_.push_back(runner);
+        }
+        cv_.notify_all();
+    }
+
+    SessionPoolOptions options_;
+    std::unique_ptr<Ort::Env> env_;
+    std::vector<std::unique_ptr<Ort::Session>> sessions_;
+
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::vector<size_t> free_runners_;
+};
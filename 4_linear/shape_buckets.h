@@ -0,0 +1,119 @@
+#pragma once
+
+#include <algorithm> // For std::sort, std::unique, std::lower_bound, std::min
+#include <cstddef>   // For size_t
+#include <cstring>   // For std::memcpy, std::memset
+#include <sstream>   // For parsing the bucket list
+#include <stdexcept> // For std::invalid_argument
+#include <string>    // For std::string
+#include <utility>   // For std::move
+#include <vector>    // For the bucket sizes
+
+// ONNX Runtime C++ API header file
+#include <onnxruntime_cxx_api.h>
+
+#include "io_binding_runner.h"
+
+// A fixed set of batch sizes ("shape buckets") that requests are padded to.
+//
+// With a dynamic batch axis, the first Run at every new batch size pays for
+// allocation planning and arena growth, which shows up as latency spikes for
+// as long as new sizes keep arriving. Rounding each batch up to one of a few
+// sizes, and running each of them once at startup, means steady-state
+// requests only ever see shapes the session has already planned.
+class ShapeBuckets {
+public:
+    // Sizes are sorted and deduplicated; they must be positive.
+    explicit ShapeBuckets(std::vector<size_t> sizes) : sizes_(std::move(sizes)) {
+        std::sort(sizes_.begin(), sizes_.end());
+        sizes_.erase(std::unique(sizes_.begin(), sizes_.end()), sizes_.end());
+        if (sizes_.empty() || sizes_.front() == 0) {
+            throw std::invalid_argument("shape buckets must be a non-empty list of positive batch sizes");
+        }
+    }
+
+    // Parses a comma separated list of positive sizes such as "1,8,64,512,4096".
+    static ShapeBuckets parse(const std::string& text) {
+        std::vector<size_t> sizes;
+        std::stringstream stream(text);
+        std::string item;
+        while (std::getline(stream, item, ',')) {
+            // std::stoul accepts a sign and wraps "-1" around to ULONG_MAX, so
+            // only plain digits are let through.
+            if (item.empty() || item.find_first_not_of("0123456789") != std::string::npos) {
+                throw std::invalid_argument("invalid bucket size: " + item);
+            }
+            unsigned long value = std::stoul(item);
+            if (value == 0) {
+                throw std::invalid_argument("invalid bucket size: " + item);
+            }
+            sizes.push_back(value);
+        }
+        return ShapeBuckets(std::move(sizes));
+    }
+
+    // Smallest bucket that holds batch_size rows, or largest() if none does
+    // (the caller then splits the batch into largest()-sized pieces).
+    size_t bucket_for(size_t batch_size) const {
+        auto it = std::lower_bound(sizes_.begin(), sizes_.end(), batch_size);
+        return it == sizes_.end() ? sizes_.back() : *it;
+    }
+
+    size_t largest() const { return sizes_.back(); }
+    const std::vector<size_t>& sizes() const { return sizes_; }
+
+private:
+    std::vector<size_t> sizes_;
+};
+
+// Runs [N, 1] batches of any size by padding them to the nearest shape bucket.
+//
+// Each bucket has its own IoBindingRunner buffers, so padding costs one copy
+// into the bucket's input and one copy of the real rows out of its output.
+// The padded rows are zeros and their outputs are discarded, which is only
+// correct for models whose rows are independent (like linear.onnx).
+class BucketedRunner {
+public:
+    // The session must outlive the runner.
+    BucketedRunner(Ort::Session& session, ShapeBuckets buckets,
+                   const char* input_name = "input", const char* output_name = "output")
+        : buckets_(std::move(buckets)), runner_(session, input_name, output_name) {}
+
+    // Runs every bucket runs_per_bucket times so the session has planned each
+    // shape (and the arena has grown to fit it) before real traffic arrives.
+    void warm_up(int runs_per_bucket = 2) {
+        for (size_t size : buckets_.sizes()) {
+            std::memset(runner_.input(size), 0, size * sizeof(float));
+            for (int i = 0; i < runs_per_bucket; ++i) {
+                runner_.run(size);
+            }
+        }
+    }
+
+    // Computes count outputs for count inputs. Batches larger than the largest
+    // bucket are run in largest()-sized pieces.
+    void run(const float* input, size_t count, float* output) {
+        while (count > 0) {
+            size_t rows = std::min(count, buckets_.largest());
+            size_t bucket = buckets_.bucket_for(rows);
+            float* bucket_input = runner_.input(bucket);
+            std::memcpy(bucket_input, input, rows * sizeof(float));
+            std::memset(bucket_input + rows, 0, (bucket - rows) * sizeof(float));
+            const float* bucket_output = runner_.run(bucket);
+            std::memcpy(output, bucket_output, rows * sizeof(float));
+            padded_rows_ += bucket - rows;
+            input += rows;
+            output += rows;
+            count -= rows;
+        }
+    }
+
+    const ShapeBuckets& buckets() const { return buckets_; }
+    // Zero rows added so far; compare with the real row count to see the padding overhead.
+    size_t padded_rows() const { return padded_rows_; }
+
+private:
+    ShapeBuckets buckets_;
+    IoBindingRunner runner_;
+    size_t padded_rows_ = 0;
+};
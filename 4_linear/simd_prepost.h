@@ -0,0 +1,358 @@
+#pragma once
+
+#include <cmath>        // For std::fabs
+#include <cstddef>      // For size_t
+#include <cstdint>      // For uint32_t/uint64_t mantissas
+#include <cstdio>       // For std::snprintf (fallback formatting)
+#include <cstdlib>      // For std::strtof (fallback parsing)
+#include <cstring>      // For std::memcpy
+#include <string>       // For std::string (fallback parsing)
+
+#if __has_include(<charconv>)
+#include <charconv>     // For std::to_chars(float), where the standard library has it
+#endif
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define SIMD_PREPOST_X86 1
+#include <immintrin.h>  // For the AVX2 intrinsics (used only in target("avx2") functions)
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+// Vectorized pre/post-processing for large float batches.
+//
+// Running the linear model on millions of rows costs a few milliseconds, but
+// parsing those rows with std::stof, checking them one by one and printing
+// each with std::endl costs far more. The helpers here keep that work cheaper
+// than the model itself:
+//
+//   - parse_floats(): splits text on ',', ' ', '\t', '\r' and '\n' with
+//     32-byte (AVX2) or 16-byte (NEON) delimiter scans, and converts plain
+//     decimal numbers with an exact fast path (strtof for everything else).
+//   - check_scaled(): one fused pass computing output - input * scale, the
+//     largest absolute error and the number of values outside tolerance.
+//   - format_floats(): shortest round-trip text (std::to_chars) written into
+//     a caller buffer, so output is one fwrite instead of one stream call per value.
+//
+// On x86 the AVX2 kernels are compiled with __attribute__((target("avx2")))
+// and chosen at run time with __builtin_cpu_supports("avx2"), so one binary
+// runs on any x86-64 CPU and uses AVX2 where it exists. NEON is part of every
+// aarch64 CPU and is used whenever the compiler targets it. Everything else
+// uses the scalar code, and every path gives identical results.
+
+namespace simd_prepost_detail {
+
+// True if the AVX2 kernels may run on this CPU; checked once.
+inline bool has_avx2() {
+#if defined(SIMD_PREPOST_X86)
+    static const bool supported = __builtin_cpu_supports("avx2");
+    return supported;
+#else
+    return false;
+#endif
+}
+
+} // namespace simd_prepost_detail
+
+// Which instruction set the vector paths use on this CPU.
+inline const char* simd_prepost_isa() {
+#if defined(SIMD_PREPOST_X86)
+    return simd_prepost_detail::has_avx2() ? "AVX2" : "scalar";
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+    return "NEON";
+#else
+    return "scalar";
+#endif
+}
+
+// --- Tolerance check ---
+
+struct ToleranceCheck {
+    size_t count = 0;
+    size_t failures = 0;               // Values with |output - input * scale| > tolerance (NaN counts).
+    size_t first_failure = static_cast<size_t>(-1);
+    float max_abs_error = 0.0f;
+};
+
+namespace simd_prepost_detail {
+
+inline bool within(float input, float output, float scale, float abs_tolerance, float rel_tolerance, float* error) {
+    float expected = input * scale;
+    *error = std::fabs(output - expected);
+    return *error <= abs_tolerance + rel_tolerance * std::fabs(expected); // False for NaN.
+}
+
+inline void check_scalar(const float* input, const float* output, size_t begin, size_t end, float scale,
+                         float abs_tolerance, float rel_tolerance, ToleranceCheck& result) {
+    for (size_t i = begin; i < end; ++i) {
+        float error;
+        if (!within(input[i], output[i], scale, abs_tolerance, rel_tolerance, &error)) {
+            if (result.failures++ == 0) {
+                result.first_failure = i;
+            }
+        }
+        if (error > result.max_abs_error) {
+            result.max_abs_error = error;
+        }
+    }
+}
+
+#if defined(SIMD_PREPOST_X86)
+// check_scaled() on whole blocks of 8 values; returns where the scalar tail starts.
+__attribute__((target("avx2"))) inline size_t check_avx2(const float* input, const float* output, size_t count,
+                                                         float scale, float abs_tolerance, float rel_tolerance,
+                                                         ToleranceCheck& result) {
+    size_t i = 0;
+    const __m256 sign_mask = _mm256_set1_ps(-0.0f);
+    const __m256 scale_v = _mm256_set1_ps(scale);
+    const __m256 abs_tol_v = _mm256_set1_ps(abs_tolerance);
+    const __m256 rel_tol_v = _mm256_set1_ps(rel_tolerance);
+    __m256 max_v = _mm256_setzero_ps();
+    for (; i + 8 <= count; i += 8) {
+        __m256 expected = _mm256_mul_ps(_mm256_loadu_ps(input + i), scale_v);
+        __m256 error = _mm256_andnot_ps(sign_mask, _mm256_sub_ps(_mm256_loadu_ps(output + i), expected));
+        __m256 limit = _mm256_add_ps(abs_tol_v, _mm256_mul_ps(rel_tol_v, _mm256_andnot_ps(sign_mask, expected)));
+        // "Not less-or-equal, unordered": true for out-of-tolerance and for NaN.
+        int failed = _mm256_movemask_ps(_mm256_cmp_ps(error, limit, _CMP_NLE_UQ));
+        if (failed != 0) {
+            if (result.failures == 0) {
+                result.first_failure = i + __builtin_ctz(static_cast<unsigned>(failed));
+            }
+            result.failures += __builtin_popcount(static_cast<unsigned>(failed));
+        }
+        max_v = _mm256_max_ps(error, max_v); // NaN errors are dropped, as in the scalar path.
+    }
+    alignas(32) float lanes[8];
+    _mm256_store_ps(lanes, max_v);
+    for (float lane : lanes) {
+        result.max_abs_error = lane > result.max_abs_error ? lane : result.max_abs_error;
+    }
+    return i;
+}
+#endif
+
+inline bool is_delimiter(char c) {
+    return c == ',' || c == ' ' || c == '\n' || c == '\r' || c == '\t';
+}
+
+#if defined(SIMD_PREPOST_X86)
+// Scans whole 32-byte blocks of [p, end) and returns the first delimiter in
+// them, or where the scalar tail starts.
+__attribute__((target("avx2"))) inline const char* find_delimiter_avx2(const char* p, const char* end) {
+    const __m256i comma = _mm256_set1_epi8(',');
+    const __m256i space = _mm256_set1_epi8(' ');
+    const __m256i newline = _mm256_set1_epi8('\n');
+    const __m256i carriage = _mm256_set1_epi8('\r');
+    const __m256i tab = _mm256_set1_epi8('\t');
+    for (; p + 32 <= end; p += 32) {
+        __m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+        __m256i hits = _mm256_or_si256(
+            _mm256_or_si256(_mm256_cmpeq_epi8(bytes, comma), _mm256_cmpeq_epi8(bytes, space)),
+            _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(bytes, newline), _mm256_cmpeq_epi8(bytes, carriage)),
+                            _mm256_cmpeq_epi8(bytes, tab)));
+        unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(hits));
+        if (mask != 0) {
+            return p + __builtin_ctz(mask);
+        }
+    }
+    return p;
+}
+#endif
+
+// strtof on a copy of [begin, end); kept out of line so the fast path stays small.
+__attribute__((noinline)) inline bool parse_float_slow(const char* begin, const char* end, float* value) {
+    char buffer[64];
+    size_t length = static_cast<size_t>(end - begin);
+    std::string long_token;
+    const char* token = buffer;
+    if (length < sizeof(buffer)) {
+        std::memcpy(buffer, begin, length);
+        buffer[length] = '\0';
+    } else {
+        long_token.assign(begin, end);
+        token = long_token.c_str();
+    }
+    char* token_end = nullptr;
+    *value = std::strtof(token, &token_end);
+    return length > 0 && token_end == token + length;
+}
+
+} // namespace simd_prepost_detail
+
+// Checks output[i] against input[i] * scale for all i in one pass. A value passes
+// when |output - expected| <= abs_tolerance + rel_tolerance * |expected|.
+inline ToleranceCheck check_scaled(const float* input, const float* output, size_t count, float scale,
+                                   float abs_tolerance, float rel_tolerance = 0.0f) {
+    ToleranceCheck result;
+    result.count = count;
+    size_t i = 0;
+#if defined(SIMD_PREPOST_X86)
+    if (simd_prepost_detail::has_avx2()) {
+        i = simd_prepost_detail::check_avx2(input, output, count, scale, abs_tolerance, rel_tolerance, result);
+    }
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+    const float32x4_t scale_v = vdupq_n_f32(scale);
+    const float32x4_t abs_tol_v = vdupq_n_f32(abs_tolerance);
+    const float32x4_t rel_tol_v = vdupq_n_f32(rel_tolerance);
+    float32x4_t max_v = vdupq_n_f32(0.0f);
+    for (; i + 4 <= count; i += 4) {
+        float32x4_t expected = vmulq_f32(vld1q_f32(input + i), scale_v);
+        float32x4_t error = vabdq_f32(vld1q_f32(output + i), expected);
+        float32x4_t limit = vaddq_f32(abs_tol_v, vmulq_f32(rel_tol_v, vabsq_f32(expected)));
+        uint32x4_t passed = vcleq_f32(error, limit); // False for NaN.
+        if (vminvq_u32(passed) == 0) {
+            uint32_t lanes[4];
+            vst1q_u32(lanes, passed);
+            for (size_t lane = 0; lane < 4; ++lane) {
+                if (lanes[lane] == 0 && result.failures++ == 0) {
+                    result.first_failure = i + lane;
+                }
+            }
+        }
+        max_v = vmaxnmq_f32(max_v, error); // Ignores NaN, as in the scalar path.
+    }
+    result.max_abs_error = vmaxvq_f32(max_v);
+#endif
+    simd_prepost_detail::check_scalar(input, output, i, count, scale, abs_tolerance, rel_tolerance, result);
+    return result;
+}
+
+// --- Parsing ---
+
+// Returns the first delimiter in [p, end), or end.
+inline const char* find_delimiter(const char* p, const char* end) {
+#if defined(SIMD_PREPOST_X86)
+    if (simd_prepost_detail::has_avx2()) {
+        p = simd_prepost_detail::find_delimiter_avx2(p, end);
+    }
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+    for (; p + 16 <= end; p += 16) {
+        uint8x16_t bytes = vld1q_u8(reinterpret_cast<const uint8_t*>(p));
+        uint8x16_t hits = vorrq_u8(
+            vorrq_u8(vceqq_u8(bytes, vdupq_n_u8(',')), vceqq_u8(bytes, vdupq_n_u8(' '))),
+            vorrq_u8(vorrq_u8(vceqq_u8(bytes, vdupq_n_u8('\n')), vceqq_u8(bytes, vdupq_n_u8('\r'))),
+                     vceqq_u8(bytes, vdupq_n_u8('\t'))));
+        if (vmaxvq_u8(hits) != 0) {
+            break; // The delimiter is in these 16 bytes; the scalar loop finds its position.
+        }
+    }
+#endif
+    while (p < end && !simd_prepost_detail::is_delimiter(*p)) {
+        ++p;
+    }
+    return p;
+}
+
+// Returns the first non-delimiter in [p, end), or end. Runs of delimiters are
+// short (usually one byte), so this stays scalar.
+inline const char* skip_delimiters(const char* p, const char* end) {
+    while (p < end && simd_prepost_detail::is_delimiter(*p)) {
+        ++p;
+    }
+    return p;
+}
+
+// Converts the token [begin, end) to a float. Returns false if it is not a number.
+//
+// Plain decimals ("-12.375", "3e-2") whose digits fit in 24 bits and whose
+// power of ten is at most 10 are computed as one float multiply or divide of
+// two exactly representable values, which is correctly rounded. Anything
+// else (long mantissas, large exponents, inf, nan, hex) goes through strtof.
+inline bool parse_float(const char* begin, const char* end, float* value) {
+    const char* p = begin;
+    bool negative = false;
+    if (p < end && (*p == '-' || *p == '+')) {
+        negative = *p == '-';
+        ++p;
+    }
+    uint64_t mantissa = 0;
+    int digits = 0;             // All digits seen.
+    int significant_digits = 0; // Digits from the first non-zero one on; at most 19 fit in mantissa.
+    int exponent = 0;
+    for (; p < end && static_cast<unsigned>(*p - '0') < 10; ++p, ++digits) {
+        mantissa = mantissa * 10 + static_cast<unsigned>(*p - '0');
+        significant_digits += mantissa != 0;
+    }
+    if (p < end && *p == '.') {
+        for (++p; p < end && static_cast<unsigned>(*p - '0') < 10; ++p, ++digits) {
+            mantissa = mantissa * 10 + static_cast<unsigned>(*p - '0');
+            significant_digits += mantissa != 0;
+            --exponent;
+        }
+    }
+    bool has_digits = digits > 0;
+    if (has_digits && p < end && (*p == 'e' || *p == 'E')) {
+        const char* q = p + 1;
+        bool exponent_negative = false;
+        if (q < end && (*q == '-' || *q == '+')) {
+            exponent_negative = *q == '-';
+            ++q;
+        }
+        int written = 0;
+        const char* exponent_begin = q;
+        for (; q < end && static_cast<unsigned>(*q - '0') < 10 && written < 1000; ++q) {
+            written = written * 10 + (*q - '0');
+        }
+        if (q > exponent_begin) {
+            exponent += exponent_negative ? -written : written;
+            p = q;
+        }
+    }
+
+    static const float kPowersOfTen[] = {1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f, 1e8f, 1e9f, 1e10f};
+    if (has_digits && p == end && significant_digits <= 19 && mantissa <= (1u << 24) && exponent >= -10 && exponent <= 10) {
+        float result = static_cast<float>(mantissa);
+        result = exponent < 0 ? result / kPowersOfTen[-exponent] : result * kPowersOfTen[exponent];
+        *value = negative ? -result : result;
+        return true;
+    }
+
+    return simd_prepost_detail::parse_float_slow(begin, end, value);
+}
+
+// Parses up to max_count delimiter-separated floats from [begin, end) into out.
+// Returns how many were parsed; *stop (if given) is set to where parsing ended,
+// which is at a bad token when parsing stopped early for that reason.
+inline size_t parse_floats(const char* begin, const char* end, float* out, size_t max_count,
+                           const char** stop = nullptr) {
+    size_t n = 0;
+    const char* p = skip_delimiters(begin, end);
+    while (n < max_count && p < end) {
+        const char* token_end = find_delimiter(p, end);
+        if (!parse_float(p, token_end, out + n)) {
+            break;
+        }
+        ++n;
+        p = skip_delimiters(token_end, end);
+    }
+    if (stop != nullptr) {
+        *stop = p;
+    }
+    return n;
+}
+
+// --- Formatting ---
+
+// Largest text format_float() writes for one value (without a separator).
+constexpr size_t kMaxFloatChars = 24;
+
+// Writes the shortest text that reads back to exactly `value`, and returns the
+// end of it. The buffer needs kMaxFloatChars bytes.
+inline char* format_float(char* p, float value) {
+#if defined(__cpp_lib_to_chars)
+    return std::to_chars(p, p + kMaxFloatChars, value).ptr;
+#else
+    return p + std::snprintf(p, kMaxFloatChars, "%.9g", value);
+#endif
+}
+
+// Formats count values, each followed by `separator`, into out and returns the
+// number of bytes written. out needs count * (kMaxFloatChars + 1) bytes.
+inline size_t format_floats(const float* values, size_t count, char separator, char* out) {
+    char* p = out;
+    for (size_t i = 0; i < count; ++i) {
+        p = format_float(p, values[i]);
+        *p++ = separator;
+    }
+    return static_cast<size_t>(p - out);
+}
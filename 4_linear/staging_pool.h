@@ -0,0 +1,112 @@
+#pragma once
+
+#include <cstddef> // For size_t
+#include <cstdlib> // For std::aligned_alloc/std::free
+#include <new>     // For std::bad_alloc
+#include <vector>  // For the per-size-class free lists
+
+// Thread-local pool of 64-byte aligned float buffers for staging input batches.
+//
+// Building a batch usually means "allocate a buffer, fill it, run, free it".
+// StagingPool::acquire() instead hands out a buffer from the calling thread's
+// free list, rounded up to a power-of-two size class, and the buffer goes back
+// to that list when the StagingBuffer is destroyed. No locks are involved, and
+// each thread keeps at most kMaxCachedBytes cached, so memory stays bounded and
+// predictable no matter how many batches are staged.
+class StagingPool {
+public:
+    class StagingBuffer {
+    public:
+        StagingBuffer(float* data, size_t size, size_t size_class)
+            : data_(data), size_(size), size_class_(size_class) {}
+        StagingBuffer(StagingBuffer&& other) noexcept
+            : data_(other.data_), size_(other.size_), size_class_(other.size_class_) {
+            other.data_ = nullptr;
+        }
+        StagingBuffer(const StagingBuffer&) = delete;
+        StagingBuffer& operator=(const StagingBuffer&) = delete;
+        StagingBuffer& operator=(StagingBuffer&&) = delete;
+        ~StagingBuffer() {
+            if (data_ != nullptr) {
+                StagingPool::release(data_, size_class_);
+            }
+        }
+
+        float* data() { return data_; }
+        const float* data() const { return data_; }
+        size_t size() const { return size_; }
+        float& operator[](size_t i) { return data_[i]; }
+
+    private:
+        float* data_;
+        size_t size_;
+        size_t size_class_;
+    };
+
+    static constexpr size_t kMinElements = 64;            // Smallest size class (256 bytes).
+    static constexpr size_t kMaxCachedBytes = 64u << 20;  // Per-thread cache limit.
+
+    // Returns a buffer with room for at least `count` floats. Contents are unspecified.
+    static StagingBuffer acquire(size_t count) {
+        size_t size_class = size_class_for(count);
+        ThreadCache& cache = thread_cache();
+        if (size_class < cache.free_lists.size() && !cache.free_lists[size_class].empty()) {
+            float* data = cache.free_lists[size_class].back();
+            cache.free_lists[size_class].pop_back();
+            cache.cached_bytes -= class_bytes(size_class);
+            return StagingBuffer(data, count, size_class);
+        }
+        float* data = static_cast<float*>(std::aligned_alloc(64, class_bytes(size_class)));
+        if (data == nullptr) {
+            throw std::bad_alloc();
+        }
+        return StagingBuffer(data, count, size_class);
+    }
+
+    // Bytes currently cached (free) on the calling thread.
+    static size_t cached_bytes() { return thread_cache().cached_bytes; }
+
+private:
+    struct ThreadCache {
+        std::vector<std::vector<float*>> free_lists;
+        size_t cached_bytes = 0;
+
+        ~ThreadCache() {
+            for (auto& list : free_lists) {
+                for (float* data : list) {
+                    std::free(data);
+                }
+            }
+        }
+    };
+
+    static ThreadCache& thread_cache() {
+        static thread_local ThreadCache cache;
+        return cache;
+    }
+
+    static size_t size_class_for(size_t count) {
+        size_t size_class = 0;
+        while ((kMinElements << size_class) < count) {
+            ++size_class;
+        }
+        return size_class;
+    }
+
+    static size_t class_bytes(size_t size_class) {
+        return (kMinElements << size_class) * sizeof(float);
+    }
+
+    static void release(float* data, size_t size_class) {
+        ThreadCache& cache = thread_cache();
+        if (cache.cached_bytes + class_bytes(size_class) > kMaxCachedBytes) {
+            std::free(data);
+            return;
+        }
+        if (cache.free_lists.size() <= size_class) {
+            cache.free_lists.resize(size_class + 1);
+        }
+        cache.free_lists[size_class].push_back(data);
+        cache.cached_bytes += class_bytes(size_class);
+    }
+};
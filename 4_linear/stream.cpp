@@ -0,0 +1,353 @@
+#include <iostream>  // For standard input/output operations (e.g., std::cout, std::cerr)
+#include <vector>    // For std::vector to hold the chunk buffers
+#include <string>    // For std::string to handle paths and argument parsing
+#include <cstdio>    // For std::FILE based chunked I/O
+#include <cstdlib>   // For EXIT_FAILURE/EXIT_SUCCESS
+#include <cstring>   // For std::strcmp, std::memmove
+#include <chrono>    // For timing the whole run
+#include <thread>    // For the reader and writer threads
+#include <exception> // For passing errors out of the pipeline threads
+#include <memory>    // For std::unique_ptr
+#include <algorithm> // For std::min
+
+#include <sys/resource.h> // For getrusage (peak RSS)
+#include <sys/stat.h>     // For fstat (binary input size)
+
+// ONNX Runtime C++ API header file
+#include <onnxruntime_cxx_api.h>
+
+#include "bounded_queue.h"
+#include "simd_prepost.h"
+
+// Streams an arbitrarily large input file through the linear model in fixed
+// size batches and writes one output value per input value.
+//
+// Input is either raw little-endian float32 values (".bin" or any other
+// extension) or text with numbers separated by commas or whitespace (".csv",
+// ".txt"). Three stages run concurrently: a reader thread fills the next chunk,
+// the main thread runs the model on the current one, and a writer thread
+// writes the previous one. The stages exchange a fixed set of chunk buffers,
+// so memory use depends only on --batch and --chunks, not on the file size.
+//
+//   ./linear_stream input.bin output.bin --batch 65536
+//   ./linear_stream input.csv output.csv
+
+namespace {
+
+enum class FileFormat { Binary, Text };
+
+FileFormat format_from_path(const std::string& path) {
+    auto ends_with = [&](const char* suffix) {
+        size_t n = std::strlen(suffix);
+        return path.size() >= n && path.compare(path.size() - n, n, suffix) == 0;
+    };
+    return ends_with(".csv") || ends_with(".txt") ? FileFormat::Text : FileFormat::Binary;
+}
+
+FileFormat parse_format(const std::string& name) {
+    if (name == "bin") {
+        return FileFormat::Binary;
+    }
+    if (name == "csv" || name == "txt") {
+        return FileFormat::Text;
+    }
+    throw std::invalid_argument("unknown format: " + name + " (expected bin or csv)");
+}
+
+struct FileCloser {
+    void operator()(std::FILE* f) const { std::fclose(f); }
+};
+using FilePtr = std::unique_ptr<std::FILE, FileCloser>;
+
+// One batch worth of input and output values. Chunks are recycled, never freed.
+struct Chunk {
+    std::vector<float> input;
+    std::vector<float> output;
+    size_t count = 0;
+};
+
+// Reads numbers separated by commas/whitespace from a file through a fixed-size buffer.
+class TextFloatReader {
+public:
+    explicit TextFloatReader(std::FILE* file) : file_(file), buffer_(kBufferSize) {}
+
+    // Reads up to max_count values into out and returns how many were read.
+    size_t read(float* out, size_t max_count) {
+        size_t n = 0;
+        while (n < max_count) {
+            // Keep at least one full token in the buffer so no number is ever cut in two.
+            if (!eof_ && end_ - pos_ < kMaxTokenSize) {
+                refill();
+            }
+            pos_ = static_cast<size_t>(skip_delimiters(buffer_.data() + pos_, buffer_.data() + end_) - buffer_.data());
+            if (pos_ == end_) {
+                if (eof_) {
+                    break;
+                }
+                continue;
+            }
+            if (!eof_ && end_ - pos_ < kMaxTokenSize) {
+                continue;
+            }
+            const char* token = buffer_.data() + pos_;
+            const char* token_end = find_delimiter(token, buffer_.data() + end_);
+            if (!parse_float(token, token_end, out + n)) {
+                throw std::runtime_error("invalid number in input near '" + std::string(token, std::min<size_t>(16, end_ - pos_)) + "'");
+            }
+            ++n;
+            pos_ = static_cast<size_t>(token_end - buffer_.data());
+        }
+        return n;
+    }
+
+private:
+    static constexpr size_t kBufferSize = 1 << 20;
+    static constexpr size_t kMaxTokenSize = 64;
+
+    void refill() {
+        size_t remaining = end_ - pos_;
+        std::memmove(buffer_.data(), buffer_.data() + pos_, remaining);
+        size_t read = std::fread(buffer_.data() + remaining, 1, kBufferSize - remaining, file_);
+        if (read == 0) {
+            eof_ = true;
+        }
+        pos_ = 0;
+        end_ = remaining + read;
+    }
+
+    std::FILE* file_;
+    std::vector<char> buffer_;
+    size_t pos_ = 0;
+    size_t end_ = 0;
+    bool eof_ = false;
+};
+
+// Writes values as text, one per line, through a fixed-size buffer.
+class TextFloatWriter {
+public:
+    explicit TextFloatWriter(std::FILE* file) : file_(file), buffer_(kBufferSize) {}
+
+    void write(const float* values, size_t count) {
+        for (size_t i = 0; i < count; ++i) {
+            if (used_ + kMaxTokenSize > buffer_.size()) {
+                flush();
+            }
+            char* end = format_float(buffer_.data() + used_, values[i]);
+            *end++ = '\n';
+            used_ = static_cast<size_t>(end - buffer_.data());
+        }
+    }
+
+    void flush() {
+        if (used_ > 0 && std::fwrite(buffer_.data(), 1, used_, file_) != used_) {
+            throw std::runtime_error("failed to write output file");
+        }
+        used_ = 0;
+    }
+
+private:
+    static constexpr size_t kBufferSize = 1 << 20;
+    static constexpr size_t kMaxTokenSize = kMaxFloatChars + 1; // Value and newline.
+
+    std::FILE* file_;
+    std::vector<char> buffer_;
+    size_t used_ = 0;
+};
+
+long peak_rss_kb() {
+    rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss; // Kilobytes on Linux.
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    const char* model_path = "data/linear/linear.onnx";
+    std::string input_path;
+    std::string output_path;
+    std::string input_format_name;
+    std::string output_format_name;
+    size_t batch_size = 65536;
+    size_t num_chunks = 3; // One being read, one being computed, one being written.
+
+    try {
+        for (int i = 1; i < argc; ++i) {
+            if (std::strcmp(argv[i], "--batch") == 0 && i + 1 < argc) {
+                batch_size = std::stoul(argv[++i]);
+            } else if (std::strcmp(argv[i], "--chunks") == 0 && i + 1 < argc) {
+                num_chunks = std::stoul(argv[++i]);
+            } else if (std::strcmp(argv[i], "--input-format") == 0 && i + 1 < argc) {
+                input_format_name = argv[++i];
+            } else if (std::strcmp(argv[i], "--output-format") == 0 && i + 1 < argc) {
+                output_format_name = argv[++i];
+            } else if (std::strcmp(argv[i], "--model") == 0 && i + 1 < argc) {
+                model_path = argv[++i];
+            } else if (argv[i][0] != '-' && input_path.empty()) {
+                input_path = argv[i];
+            } else if (argv[i][0] != '-' && output_path.empty()) {
+                output_path = argv[i];
+            } else {
+                throw std::invalid_argument(argv[i]);
+            }
+        }
+        if (input_path.empty() || output_path.empty() || batch_size == 0 || num_chunks < 2) {
+            throw std::invalid_argument("missing arguments");
+        }
+    } catch (const std::exception&) {
+        std::cerr << "Usage: " << argv[0] << " <input_file> <output_file> [--batch N] [--chunks N]"
+                  << " [--input-format bin|csv] [--output-format bin|csv] [--model <model_path>]" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    try {
+        FileFormat input_format = input_format_name.empty() ? format_from_path(input_path) : parse_format(input_format_name);
+        FileFormat output_format = output_format_name.empty() ? format_from_path(output_path) : parse_format(output_format_name);
+
+        FilePtr input_file(std::fopen(input_path.c_str(), input_format == FileFormat::Binary ? "rb" : "r"));
+        if (!input_file) {
+            std::cerr << "Error: cannot open " << input_path << " for reading." << std::endl;
+            return EXIT_FAILURE;
+        }
+        // fread would silently drop a trailing partial float, so reject such files up front.
+        struct stat input_info;
+        if (input_format == FileFormat::Binary && ::fstat(fileno(input_file.get()), &input_info) == 0 &&
+            S_ISREG(input_info.st_mode) && input_info.st_size % sizeof(float) != 0) {
+            throw std::runtime_error(input_path + " is " + std::to_string(input_info.st_size) +
+                                     " bytes, not a whole number of float32 values");
+        }
+        FilePtr output_file(std::fopen(output_path.c_str(), output_format == FileFormat::Binary ? "wb" : "w"));
+        if (!output_file) {
+            std::cerr << "Error: cannot open " << output_path << " for writing." << std::endl;
+            return EXIT_FAILURE;
+        }
+
+        Ort::Env env(ORT_LOGGING_LEVEL_WARNING, "linear_stream");
+        Ort::Session session(env, model_path, Ort::SessionOptions());
+        auto memory_info = Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
+
+        // --- 1. Allocate the fixed set of chunks that circulate through the pipeline ---
+        std::vector<Chunk> chunks(num_chunks);
+        BoundedQueue<Chunk*> free_chunks(num_chunks);
+        BoundedQueue<Chunk*> read_chunks(num_chunks);
+        BoundedQueue<Chunk*> computed_chunks(num_chunks);
+        for (auto& chunk : chunks) {
+            chunk.input.resize(batch_size);
+            chunk.output.resize(batch_size);
+            free_chunks.push(&chunk);
+        }
+
+        std::exception_ptr reader_error;
+        std::exception_ptr writer_error;
+        auto stop_pipeline = [&] {
+            free_chunks.close();
+            read_chunks.close();
+            computed_chunks.close();
+        };
+
+        auto begin = std::chrono::steady_clock::now();
+
+        // --- 2. Reader: fill free chunks from the input file ---
+        std::thread reader([&] {
+            try {
+                TextFloatReader text_reader(input_file.get());
+                Chunk* chunk;
+                while (free_chunks.pop(chunk)) {
+                    if (input_format == FileFormat::Binary) {
+                        chunk->count = std::fread(chunk->input.data(), sizeof(float), batch_size, input_file.get());
+                    } else {
+                        chunk->count = text_reader.read(chunk->input.data(), batch_size);
+                    }
+                    if (chunk->count == 0 || !read_chunks.push(chunk)) {
+                        break;
+                    }
+                    if (chunk->count < batch_size) {
+                        break; // Short read: end of file.
+                    }
+                }
+                if (std::ferror(input_file.get())) {
+                    throw std::runtime_error("failed to read input file");
+                }
+            } catch (...) {
+                reader_error = std::current_exception();
+                stop_pipeline();
+            }
+            read_chunks.close();
+        });
+
+        // --- 3. Writer: write computed chunks and return them to the free list ---
+        size_t rows_written = 0;
+        std::thread writer([&] {
+            try {
+                TextFloatWriter text_writer(output_file.get());
+                Chunk* chunk;
+                while (computed_chunks.pop(chunk)) {
+                    if (output_format == FileFormat::Binary) {
+                        if (std::fwrite(chunk->output.data(), sizeof(float), chunk->count, output_file.get()) != chunk->count) {
+                            throw std::runtime_error("failed to write output file");
+                        }
+                    } else {
+                        text_writer.write(chunk->output.data(), chunk->count);
+                    }
+                    rows_written += chunk->count;
+                    free_chunks.push(chunk);
+                }
+                text_writer.flush();
+            } catch (...) {
+                writer_error = std::current_exception();
+                stop_pipeline();
+            }
+        });
+
+        // --- 4. Compute on the main thread ---
+        size_t batches = 0;
+        try {
+            const char* input_name = "input";
+            const char* output_name = "output";
+            Chunk* chunk;
+            while (read_chunks.pop(chunk)) {
+                int64_t shape[2] = {static_cast<int64_t>(chunk->count), 1};
+                Ort::Value input_tensor = Ort::Value::CreateTensor<float>(
+                    memory_info, chunk->input.data(), chunk->count, shape, 2);
+                Ort::Value output_tensor = Ort::Value::CreateTensor<float>(
+                    memory_info, chunk->output.data(), chunk->count, shape, 2);
+                session.Run(Ort::RunOptions{nullptr},
+                            &input_name, &input_tensor, 1,
+                            &output_name, &output_tensor, 1);
+                batches += 1;
+                computed_chunks.push(chunk);
+            }
+        } catch (...) {
+            stop_pipeline();
+            reader.join();
+            writer.join();
+            throw;
+        }
+        computed_chunks.close();
+        reader.join();
+        writer.join();
+        if (reader_error) {
+            std::rethrow_exception(reader_error);
+        }
+        if (writer_error) {
+            std::rethrow_exception(writer_error);
+        }
+        if (std::fflush(output_file.get()) != 0) {
+            throw std::runtime_error("failed to write output file");
+        }
+
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+        std::cout << "Rows: " << rows_written << " in " << batches << " batches of up to " << batch_size << std::endl;
+        std::cout << "Time: " << seconds << " s (" << rows_written / seconds << " rows/s)" << std::endl;
+        std::cout << "Peak RSS: " << peak_rss_kb() << " KB" << std::endl;
+
+    } catch (const Ort::Exception& ex) {
+        std::cerr << "ONNX Runtime Error: " << ex.what() << std::endl;
+        return EXIT_FAILURE;
+    } catch (const std::exception& ex) {
+        std::cerr << "Standard C++ Error: " << ex.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,196 @@
+#include "inference_runner.h"
+
+#include <stdexcept> // For std::invalid_argument
+
+#include "metrics.h"      // For the stage timings
+#include "tensor_info.h"  // For tensor_element_size, get_tensor_data_type_string
+#include "typed_tensor.h" // For convert_from_float, convert_to_float
+
+namespace {
+
+// Time spent in each stage of loading and running a model, exported through
+// Metrics::global() (see metrics.h). Registered on first use.
+struct RunnerMetrics {
+    MetricHistogram session_create = Metrics::global().histogram(
+        "inference_runner_session_create_seconds", "Time to create an Ort::Session from a model file");
+    MetricHistogram tensor_create = Metrics::global().histogram(
+        "inference_runner_tensor_create_seconds", "Time to wrap (and convert) the input and output tensors");
+    MetricHistogram run = Metrics::global().histogram(
+        "inference_runner_run_seconds", "Time spent in Session::Run");
+    MetricHistogram output_copy = Metrics::global().histogram(
+        "inference_runner_output_copy_seconds", "Time to copy or convert the output to float");
+    MetricCounter runs = Metrics::global().counter(
+        "inference_runner_runs_total", "Completed InferenceRunner runs");
+};
+
+const RunnerMetrics& runner_metrics() {
+    static const RunnerMetrics metrics;
+    return metrics;
+}
+
+std::unique_ptr<Ort::Session> create_session(Ort::Env& env, const char* model_path,
+                                             const Ort::SessionOptions& session_options) {
+    ScopedTimer timer(runner_metrics().session_create);
+    return std::make_unique<Ort::Session>(env, model_path, session_options);
+}
+
+// Reads the metadata of one input or output from its type info.
+TensorMetadata read_tensor_metadata(std::string name, const Ort::TypeInfo& type_info) {
+    TensorMetadata metadata;
+    metadata.name = std::move(name);
+    if (type_info.GetONNXType() != ONNX_TYPE_TENSOR) {
+        return metadata; // Sequences and maps keep an undefined element type and no shape.
+    }
+    auto tensor_info = type_info.GetTensorTypeAndShapeInfo();
+    metadata.type = tensor_info.GetElementType();
+    metadata.shape = tensor_info.GetShape();
+    for (const char* symbolic : tensor_info.GetSymbolicDimensions()) {
+        metadata.symbolic_dims.push_back(symbolic != nullptr ? symbolic : "");
+    }
+    return metadata;
+}
+
+} // namespace
+
+InferenceRunner::InferenceRunner(Ort::Session& session)
+    : session_(&session),
+      memory_info_(Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault)) {
+    read_metadata();
+}
+
+InferenceRunner::InferenceRunner(Ort::Env& env, const char* model_path, const Ort::SessionOptions& session_options)
+    : owned_session_(create_session(env, model_path, session_options)),
+      session_(owned_session_.get()),
+      memory_info_(Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault)) {
+    read_metadata();
+}
+
+void InferenceRunner::read_metadata() {
+    // Names are copied out of the allocated strings, so the runner owns them
+    // and the C-string arrays stay valid for its lifetime.
+    Ort::AllocatorWithDefaultOptions allocator;
+    for (size_t i = 0; i < session_->GetInputCount(); ++i) {
+        inputs_.push_back(read_tensor_metadata(session_->GetInputNameAllocated(i, allocator).get(),
+                                               session_->GetInputTypeInfo(i)));
+    }
+    for (size_t i = 0; i < session_->GetOutputCount(); ++i) {
+        outputs_.push_back(read_tensor_metadata(session_->GetOutputNameAllocated(i, allocator).get(),
+                                                session_->GetOutputTypeInfo(i)));
+    }
+    for (const auto& input : inputs_) {
+        input_name_ptrs_.push_back(input.name.c_str());
+    }
+    for (const auto& output : outputs_) {
+        output_name_ptrs_.push_back(output.name.c_str());
+    }
+}
+
+size_t InferenceRunner::prepare_shapes(size_t input_elements) {
+    if (inputs_.size() != 1 || outputs_.size() != 1) {
+        throw std::invalid_argument("InferenceRunner::run needs a model with one input and one output");
+    }
+
+    // --- Input shape: the dynamic dimension absorbs whatever the static ones don't cover ---
+    input_shape_.assign(inputs_[0].shape.begin(), inputs_[0].shape.end());
+    size_t static_elements = 1;
+    size_t dynamic_index = input_shape_.size();
+    for (size_t d = 0; d < input_shape_.size(); ++d) {
+        if (input_shape_[d] != -1) {
+            static_elements *= static_cast<size_t>(input_shape_[d]);
+        } else if (dynamic_index == input_shape_.size()) {
+            dynamic_index = d;
+        } else {
+            throw std::invalid_argument("InferenceRunner::run supports at most one dynamic input dimension");
+        }
+    }
+    int64_t dynamic_value = 1;
+    if (dynamic_index < input_shape_.size()) {
+        if (static_elements == 0 || input_elements % static_elements != 0) {
+            throw std::invalid_argument("input size does not fit the model's input shape");
+        }
+        dynamic_value = static_cast<int64_t>(input_elements / static_elements);
+        input_shape_[dynamic_index] = dynamic_value;
+    } else if (input_elements != static_elements) {
+        throw std::invalid_argument("input size does not match the model's static input shape");
+    }
+
+    // --- Output shape: dynamic dimensions take the same value ---
+    output_shape_.assign(outputs_[0].shape.begin(), outputs_[0].shape.end());
+    size_t output_elements = 1;
+    for (int64_t& dim : output_shape_) {
+        if (dim == -1) {
+            dim = dynamic_value;
+        }
+        output_elements *= static_cast<size_t>(dim);
+    }
+    return output_elements;
+}
+
+Span<const float> InferenceRunner::run(Span<const float> input) {
+    if (inputs_.size() != 1 || outputs_.size() != 1 ||
+        inputs_[0].type != ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT ||
+        outputs_[0].type != ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT) {
+        throw std::invalid_argument("InferenceRunner::run needs a model with one float input and one float output");
+    }
+    size_t output_elements = prepare_shapes(input.size());
+    if (output_buffer_.size() < output_elements) {
+        output_buffer_.resize(output_elements);
+    }
+
+    const RunnerMetrics& metrics = runner_metrics();
+    StageTimer stages;
+    // ORT only reads input tensors, so wrapping the caller's const data is safe.
+    Ort::Value input_tensor = Ort::Value::CreateTensor<float>(
+        memory_info_, const_cast<float*>(input.data()), input.size(), input_shape_.data(), input_shape_.size());
+    Ort::Value output_tensor = Ort::Value::CreateTensor<float>(
+        memory_info_, output_buffer_.data(), output_elements, output_shape_.data(), output_shape_.size());
+    stages.lap(metrics.tensor_create);
+    session_->Run(Ort::RunOptions{nullptr}, input_names(), &input_tensor, 1, output_names(), &output_tensor, 1);
+    stages.lap(metrics.run);
+    metrics.runs.add();
+    return Span<const float>(output_buffer_.data(), output_elements);
+}
+
+Span<const float> InferenceRunner::run_converted(Span<const float> input) {
+    size_t output_elements = prepare_shapes(input.size());
+    ONNXTensorElementDataType input_type = inputs_[0].type;
+    ONNXTensorElementDataType output_type = outputs_[0].type;
+    size_t input_element_size = tensor_element_size(input_type);
+    size_t output_element_size = tensor_element_size(output_type);
+    if (!is_convertible_from_float(input_type) || !is_convertible_from_float(output_type)) {
+        throw std::invalid_argument("InferenceRunner::run_converted needs numeric input and output types, not " +
+                                    get_tensor_data_type_string(input_type) + " -> " +
+                                    get_tensor_data_type_string(output_type));
+    }
+
+    // --- Convert the input into the model's element type and wrap the typed buffers ---
+    const RunnerMetrics& metrics = runner_metrics();
+    StageTimer stages;
+    size_t input_bytes = input.size() * input_element_size;
+    size_t output_bytes = output_elements * output_element_size;
+    if (typed_input_.size() < input_bytes) {
+        typed_input_.resize(input_bytes);
+    }
+    if (typed_output_.size() < output_bytes) {
+        typed_output_.resize(output_bytes);
+    }
+    convert_from_float(input.data(), input.size(), input_type, typed_input_.data());
+    Ort::Value input_tensor = Ort::Value::CreateTensor(
+        memory_info_, typed_input_.data(), input_bytes, input_shape_.data(), input_shape_.size(), input_type);
+    Ort::Value output_tensor = Ort::Value::CreateTensor(
+        memory_info_, typed_output_.data(), output_bytes, output_shape_.data(), output_shape_.size(), output_type);
+    stages.lap(metrics.tensor_create);
+
+    // --- Run on the typed buffers ---
+    session_->Run(Ort::RunOptions{nullptr}, input_names(), &input_tensor, 1, output_names(), &output_tensor, 1);
+    stages.lap(metrics.run);
+
+    // --- Convert the output back to float ---
+    if (output_buffer_.size() < output_elements) {
+        output_buffer_.resize(output_elements);
+    }
+    convert_to_float(typed_output_.data(), output_elements, output_type, output_buffer_.data());
+    stages.lap(metrics.output_copy);
+    metrics.runs.add();
+    return Span<const float>(output_buffer_.data(), output_elements);
+}
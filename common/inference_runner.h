@@ -0,0 +1,95 @@
+#pragma once
+
+#include <cstdint> // For int64_t dimensions
+#include <memory>  // For std::unique_ptr
+#include <string>  // For std::string names
+#include <vector>  // For the cached metadata and buffers
+
+// ONNX Runtime C++ API header file
+#include <onnxruntime_cxx_api.h>
+
+#include "span.h"
+
+// Name, element type and shape of one model input or output, as reported by
+// the session. Dynamic dimensions are -1; symbolic_dims holds their names
+// (e.g. "batch_size"), or "" where the model does not name them.
+struct TensorMetadata {
+    std::string name;
+    ONNXTensorElementDataType type = ONNX_TENSOR_ELEMENT_DATA_TYPE_UNDEFINED;
+    std::vector<int64_t> shape;
+    std::vector<std::string> symbolic_dims;
+};
+
+// Reads every input's and output's metadata once and runs the model without
+// repeating the name/shape boilerplate on each call.
+//
+//   InferenceRunner runner(env, "data/linear/linear.onnx");
+//   Span<const float> output = runner.run(input_values);
+//
+// The C-string name arrays are built once, so input_names()/output_names()
+// can be passed straight to Session::Run. run() reuses its shape and output
+// buffers, so after the first call at a given batch size it allocates no
+// strings or vectors. A runner is not thread-safe; use one per thread.
+//
+// While Metrics::global() is enabled (metrics.h), session creation, tensor
+// creation, Run and output conversion are timed into its inference_runner_*
+// histograms.
+class InferenceRunner {
+public:
+    // Uses an existing session, which must outlive the runner.
+    explicit InferenceRunner(Ort::Session& session);
+    // Creates and owns a session for model_path.
+    InferenceRunner(Ort::Env& env, const char* model_path,
+                    const Ort::SessionOptions& session_options = Ort::SessionOptions());
+
+    InferenceRunner(const InferenceRunner&) = delete;
+    InferenceRunner& operator=(const InferenceRunner&) = delete;
+
+    Ort::Session& session() { return *session_; }
+
+    const std::vector<TensorMetadata>& inputs() const { return inputs_; }
+    const std::vector<TensorMetadata>& outputs() const { return outputs_; }
+    const char* const* input_names() const { return input_name_ptrs_.data(); }
+    const char* const* output_names() const { return output_name_ptrs_.data(); }
+    size_t input_count() const { return inputs_.size(); }
+    size_t output_count() const { return outputs_.size(); }
+
+    // Runs a model with one float input and one float output on `input`.
+    //
+    // The input's dynamic dimension (at most one, normally the batch axis) is
+    // set so the shape holds input.size() elements, and the same value is used
+    // for the output's dynamic dimensions. The returned span points into a
+    // buffer owned by the runner and stays valid until the next run().
+    // Throws std::invalid_argument if the model or input does not fit.
+    Span<const float> run(Span<const float> input);
+
+    // Like run(), but for a model whose single input and output may have any
+    // numeric element type (e.g. an FP16 or quantized variant of a float model):
+    // the input is converted from float to the model's input type and the
+    // output back to float (see typed_tensor.h). For float models this is
+    // run() plus two copies.
+    Span<const float> run_converted(Span<const float> input);
+
+private:
+    void read_metadata();
+    // Checks the single input/output and sets input_shape_/output_shape_ for
+    // input_elements input values; returns the output element count.
+    size_t prepare_shapes(size_t input_elements);
+
+    std::unique_ptr<Ort::Session> owned_session_;
+    Ort::Session* session_;
+
+    std::vector<TensorMetadata> inputs_;
+    std::vector<TensorMetadata> outputs_;
+    std::vector<const char*> input_name_ptrs_;
+    std::vector<const char*> output_name_ptrs_;
+
+    // Reused by run().
+    Ort::MemoryInfo memory_info_;
+    std::vector<int64_t> input_shape_;
+    std::vector<int64_t> output_shape_;
+    std::vector<float> output_buffer_;
+    // Element-typed staging buffers used by run_converted().
+    std::vector<unsigned char> typed_input_;
+    std::vector<unsigned char> typed_output_;
+};
@@ -0,0 +1,108 @@
+#include "mapped_model.h"
+
+#include <cerrno>    // For errno
+#include <cstring>   // For std::memcmp, std::strerror
+#include <stdexcept> // For std::runtime_error
+#include <utility>   // For std::move
+
+// POSIX headers for open/fstat/mmap
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+MappedFile::MappedFile(const std::string& path, bool prefetch) : path_(path) {
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        throw std::runtime_error("cannot open " + path + ": " + std::strerror(errno));
+    }
+    struct stat info;
+    if (::fstat(fd, &info) < 0) {
+        int error = errno;
+        ::close(fd);
+        throw std::runtime_error("cannot stat " + path + ": " + std::strerror(error));
+    }
+    if (info.st_size == 0) {
+        ::close(fd);
+        throw std::runtime_error("cannot map " + path + ": empty file");
+    }
+    size_ = static_cast<size_t>(info.st_size);
+    // MAP_SHARED + PROT_READ: the pages come straight from the page cache and
+    // are never copied, so every process mapping the file shares them.
+    void* data = ::mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd, 0);
+    int error = errno;
+    ::close(fd); // The mapping keeps its own reference to the file.
+    if (data == MAP_FAILED) {
+        throw std::runtime_error("cannot map " + path + ": " + std::strerror(error));
+    }
+    data_ = data;
+    if (prefetch) {
+        ::madvise(data_, size_, MADV_WILLNEED);
+    }
+}
+
+MappedFile::~MappedFile() {
+    if (data_ != nullptr) {
+        ::munmap(data_, size_);
+    }
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+    : path_(std::move(other.path_)), data_(other.data_), size_(other.size_) {
+    other.data_ = nullptr;
+    other.size_ = 0;
+}
+
+bool MappedModel::has_ort_format_header(const void* data, size_t size) {
+    // A flatbuffer starts with a 4-byte root offset followed by its file identifier.
+    return size >= 8 && std::memcmp(static_cast<const char*>(data) + 4, "ORTM", 4) == 0;
+}
+
+MappedModel::MappedModel(Ort::Env& env, const std::string& model_path, Ort::SessionOptions& session_options,
+                         const MappedModelOptions& options)
+    : model_file_(model_path, options.prefetch),
+      is_ort_format_(has_ort_format_header(model_file_.data(), model_file_.size())) {
+    if (options.disable_prepacking) {
+        session_options.AddConfigEntry("session.disable_prepacking", "1");
+    }
+    if (is_ort_format_) {
+        session_options.AddConfigEntry("session.load_model_format", "ORT");
+        if (options.use_bytes_directly) {
+            session_options.AddConfigEntry("session.use_ort_model_bytes_directly", "1");
+            if (options.use_bytes_for_initializers) {
+                session_options.AddConfigEntry("session.use_ort_model_bytes_for_initializers", "1");
+            }
+        }
+    }
+
+    // --- External data files, found next to the model like ORT would ---
+    if (!options.external_data_files.empty()) {
+#if ORT_API_VERSION >= 18
+        size_t slash = model_path.find_last_of('/');
+        std::string directory = slash == std::string::npos ? "" : model_path.substr(0, slash + 1);
+        std::vector<std::basic_string<ORTCHAR_T>> names;
+        std::vector<char*> buffers;
+        std::vector<size_t> lengths;
+        for (const std::string& name : options.external_data_files) {
+            external_files_.emplace_back(directory + name, options.prefetch);
+            names.emplace_back(name.begin(), name.end());
+            // ORT only reads the buffers; the API just isn't const-correct.
+            buffers.push_back(static_cast<char*>(const_cast<void*>(external_files_.back().data())));
+            lengths.push_back(external_files_.back().size());
+        }
+        session_options.AddExternalInitializersFromFilesInMemory(names, buffers, lengths);
+#else
+        throw std::runtime_error("mapping external data files needs ONNX Runtime 1.18 or newer");
+#endif
+    }
+
+    session_ = std::make_unique<Ort::Session>(env, model_file_.data(), model_file_.size(), session_options);
+}
+
+size_t MappedModel::mapped_bytes() const {
+    size_t bytes = model_file_.size();
+    for (const MappedFile& file : external_files_) {
+        bytes += file.size();
+    }
+    return bytes;
+}
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <cstddef> // For size_t
+#include <memory>  // For std::unique_ptr sessions
+#include <string>  // For paths
+#include <vector>  // For the external data files
+
+// ONNX Runtime C++ API header file
+#include <onnxruntime_cxx_api.h>
+
+// A whole file mapped read-only into memory.
+//
+// The mapping is shared with the page cache: every process that maps the same
+// file reads the same physical pages, and they are only loaded from disk when
+// first touched. Throws std::runtime_error if the file cannot be mapped.
+//
+// Because the pages are the file's own, a mapped file must never be modified
+// in place. Writing into it (cp, or truncating and rewriting it) changes the
+// bytes under every process that maps it, and truncating makes reads past
+// the new end raise SIGBUS. Replace it only by writing a new file and
+// renaming it over the old one: the mapping keeps the old inode alive.
+class MappedFile {
+public:
+    explicit MappedFile(const std::string& path, bool prefetch = false);
+    ~MappedFile();
+
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile& operator=(MappedFile&&) = delete;
+
+    const void* data() const { return data_; }
+    size_t size() const { return size_; }
+    const std::string& path() const { return path_; }
+
+private:
+    std::string path_;
+    void* data_ = nullptr;
+    size_t size_ = 0;
+};
+
+struct MappedModelOptions {
+    // ORT format only (session.use_ort_model_bytes_directly): the session keeps
+    // reading the mapped bytes instead of copying the model into its own buffer.
+    bool use_bytes_directly = true;
+    // ORT format only, needs use_bytes_directly
+    // (session.use_ort_model_bytes_for_initializers): initializers are used
+    // in place from the mapped bytes instead of being copied into tensors.
+    bool use_bytes_for_initializers = true;
+    // External data files of an .onnx model, named exactly as its initializers
+    // refer to them and relative to the model's directory. Each one is mapped
+    // and handed to ORT in memory (AddExternalInitializersFromFilesInMemory),
+    // which uses the weights in place. Needs ONNX Runtime 1.18 or newer; older
+    // versions throw std::runtime_error when this is not empty.
+    std::vector<std::string> external_data_files;
+    // Ask the kernel to read the files ahead (MADV_WILLNEED) instead of
+    // faulting them in page by page during session creation.
+    bool prefetch = false;
+    // session.disable_prepacking=1: MatMul/Gemm kernels normally repack
+    // constant weights into their own layout when the session is created.
+    // The packed copy is private memory, so with prepacking every worker
+    // again holds its own copy of those weights. Disabling it keeps the
+    // mapped weights as the only copy, at the cost of some MatMul/Gemm speed
+    // (the kernels pack on every run instead). Set to false when the model is
+    // small or only one process serves it.
+    bool disable_prepacking = true;
+};
+
+// An Ort::Session created from a memory-mapped model file.
+//
+// Ort::Session(env, path, options) reads the file into a private buffer and
+// copies every initializer into its own tensors, so N worker processes
+// serving the same model hold N copies of its weights. MappedModel maps the
+// model instead and creates the session from the mapped bytes, configured so
+// the weights are used where they are mapped:
+//
+// - An ORT-format model (.ort, detected from its header) is used directly,
+//   initializers included.
+// - An .onnx model's external data files are used directly. Initializers
+//   stored inside the .onnx protobuf are still copied, so for sharing, save
+//   large models with external data (see data/linear/linear.py).
+//
+// The mappings live as long as the MappedModel and are released after the
+// session, which may point into them. The files must not be modified while
+// they are mapped (see MappedFile); replace them by rename.
+//
+//   MappedModelOptions options;
+//   options.external_data_files = {"linear_large.onnx.data"};
+//   MappedModel model(env, "data/linear/linear_large.onnx", session_options, options);
+//   InferenceRunner runner(model.session());
+class MappedModel {
+public:
+    // The config entries are added to session_options, so pass
+    // session_options.Clone() if it is reused elsewhere. Throws
+    // std::runtime_error if a file cannot be mapped and Ort::Exception if the
+    // session cannot be created.
+    MappedModel(Ort::Env& env, const std::string& model_path, Ort::SessionOptions& session_options,
+                const MappedModelOptions& options = MappedModelOptions());
+
+    MappedModel(const MappedModel&) = delete;
+    MappedModel& operator=(const MappedModel&) = delete;
+
+    Ort::Session& session() { return *session_; }
+    bool is_ort_format() const { return is_ort_format_; }
+    // Bytes of the model and external data files mapped for this session.
+    size_t mapped_bytes() const;
+
+    // True if the data starts like an ORT-format model (flatbuffer identifier "ORTM").
+    static bool has_ort_format_header(const void* data, size_t size);
+
+private:
+    // Declared before session_ so they are unmapped after it is destroyed.
+    MappedFile model_file_;
+    std::vector<MappedFile> external_files_;
+    bool is_ort_format_;
+    std::unique_ptr<Ort::Session> session_;
+};
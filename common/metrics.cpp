@@ -0,0 +1,221 @@
+#include "metrics.h"
+
+#include <cstdio>    // For std::snprintf, std::rename
+#include <fstream>   // For dump_to_file
+#include <stdexcept> // For std::length_error
+#include <utility>   // For std::move
+
+namespace {
+
+// Bucket boundaries ("le" labels) exported for every histogram, in seconds.
+// The fine log-linear buckets are summed into these when rendering.
+const double kExportBoundsSeconds[] = {
+    1e-6, 2.5e-6, 5e-6, 1e-5, 2.5e-5, 5e-5, 1e-4, 2.5e-4, 5e-4,
+    1e-3, 2.5e-3, 5e-3, 1e-2, 2.5e-2, 5e-2, 0.1, 0.25, 0.5, 1.0, 2.5, 5.0, 10.0,
+};
+
+std::string format_number(double value) {
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%.9g", value);
+    return buffer;
+}
+
+// HELP text must not contain raw backslashes or newlines.
+std::string escape_help(const std::string& help) {
+    std::string escaped;
+    for (char c : help) {
+        if (c == '\\') {
+            escaped += "\\\\";
+        } else if (c == '\n') {
+            escaped += "\\n";
+        } else {
+            escaped += c;
+        }
+    }
+    return escaped;
+}
+
+} // namespace
+
+uint64_t HistogramSnapshot::percentile_ns(double p) const {
+    if (count == 0) {
+        return 0;
+    }
+    uint64_t rank = static_cast<uint64_t>(p / 100.0 * (count - 1) + 0.5) + 1;
+    uint64_t seen = 0;
+    for (size_t i = 0; i < buckets.size(); ++i) {
+        seen += buckets[i];
+        if (seen >= rank) {
+            return i + 1 < Metrics::kBuckets ? Metrics::bucket_lower_bound(i + 1) - 1 : Metrics::bucket_lower_bound(i);
+        }
+    }
+    return Metrics::bucket_lower_bound(buckets.size() - 1);
+}
+
+Metrics& Metrics::global() {
+    // Never destroyed, so threads still recording during static destruction stay safe.
+    static Metrics* metrics = new Metrics();
+    return *metrics;
+}
+
+MetricCounter Metrics::counter(const std::string& name, const std::string& help) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (size_t id = 0; id < counters_.size(); ++id) {
+        if (counters_[id].name == name) {
+            return MetricCounter(this, id);
+        }
+    }
+    if (counters_.size() == kMaxCounters) {
+        throw std::length_error("too many metric counters (kMaxCounters)");
+    }
+    counters_.push_back({name, help});
+    return MetricCounter(this, counters_.size() - 1);
+}
+
+MetricHistogram Metrics::histogram(const std::string& name, const std::string& help) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (size_t id = 0; id < histograms_.size(); ++id) {
+        if (histograms_[id].name == name) {
+            return MetricHistogram(this, id);
+        }
+    }
+    if (histograms_.size() == kMaxHistograms) {
+        throw std::length_error("too many metric histograms (kMaxHistograms)");
+    }
+    histograms_.push_back({name, help});
+    return MetricHistogram(this, histograms_.size() - 1);
+}
+
+uint64_t Metrics::bucket_lower_bound(size_t index) {
+    if (index < kSubBuckets) {
+        return index;
+    }
+    size_t row = index / kSubBuckets; // 1 for values 16..31, 2 for 32..63, ...
+    uint64_t sub_bucket = index % kSubBuckets;
+    return (kSubBuckets + sub_bucket) << (row - 1);
+}
+
+Metrics::Shard& Metrics::register_shard() {
+    {
+        // The previous owner has exited, and the mutex orders its last stores
+        // before this thread's first ones, so each cell still has one writer.
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!free_shards_.empty()) {
+            Shard* shard = free_shards_.back();
+            free_shards_.pop_back();
+            return *shard;
+        }
+    }
+    std::unique_ptr<Shard> shard(new Shard()); // Value-initialized: every cell starts at 0.
+    std::lock_guard<std::mutex> lock(mutex_);
+    shards_.push_back(std::move(shard));
+    return *shards_.back();
+}
+
+void Metrics::release_shard(Shard* shard) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    free_shards_.push_back(shard); // Still in shards_, so its counts keep being exported.
+}
+
+std::vector<const Metrics::Shard*> Metrics::shards_snapshot() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<const Shard*> shards;
+    shards.reserve(shards_.size());
+    for (const auto& shard : shards_) {
+        shards.push_back(shard.get());
+    }
+    return shards;
+}
+
+uint64_t Metrics::counter_value(size_t id) const {
+    uint64_t total = 0;
+    for (const Shard* shard : shards_snapshot()) {
+        total += shard->counters[id].load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+HistogramSnapshot Metrics::histogram_snapshot(size_t id) const {
+    HistogramSnapshot snapshot;
+    snapshot.buckets.assign(kBuckets, 0);
+    for (const Shard* shard : shards_snapshot()) {
+        const HistogramCells& cells = shard->histograms[id];
+        for (size_t b = 0; b < kBuckets; ++b) {
+            snapshot.buckets[b] += cells.buckets[b].load(std::memory_order_relaxed);
+        }
+        snapshot.count += cells.count.load(std::memory_order_relaxed);
+        snapshot.sum_ns += cells.sum_ns.load(std::memory_order_relaxed);
+    }
+    return snapshot;
+}
+
+std::string Metrics::render_prometheus() const {
+    std::vector<Definition> counters;
+    std::vector<Definition> histograms;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        counters = counters_;
+        histograms = histograms_;
+    }
+
+    std::string text;
+    for (size_t id = 0; id < counters.size(); ++id) {
+        const std::string& name = counters[id].name;
+        text += "# HELP " + name + " " + escape_help(counters[id].help) + "\n";
+        text += "# TYPE " + name + " counter\n";
+        text += name + " " + std::to_string(counter_value(id)) + "\n";
+    }
+    for (size_t id = 0; id < histograms.size(); ++id) {
+        const std::string& name = histograms[id].name;
+        HistogramSnapshot snapshot = histogram_snapshot(id);
+        text += "# HELP " + name + " " + escape_help(histograms[id].help) + "\n";
+        text += "# TYPE " + name + " histogram\n";
+        // A fine bucket counts towards "le" once every value it can hold is <= le.
+        size_t bucket = 0;
+        uint64_t cumulative = 0;
+        for (double bound_seconds : kExportBoundsSeconds) {
+            uint64_t bound_ns = static_cast<uint64_t>(bound_seconds * 1e9);
+            while (bucket + 1 < kBuckets && bucket_lower_bound(bucket + 1) - 1 <= bound_ns) {
+                cumulative += snapshot.buckets[bucket++];
+            }
+            text += name + "_bucket{le=\"" + format_number(bound_seconds) + "\"} " + std::to_string(cumulative) + "\n";
+        }
+        text += name + "_bucket{le=\"+Inf\"} " + std::to_string(snapshot.count) + "\n";
+        text += name + "_sum " + format_number(snapshot.sum_ns / 1e9) + "\n";
+        text += name + "_count " + std::to_string(snapshot.count) + "\n";
+    }
+    return text;
+}
+
+bool Metrics::dump_to_file(const std::string& path) const {
+    std::string temporary_path = path + ".tmp";
+    {
+        std::ofstream file(temporary_path, std::ios::trunc);
+        if (!file || !(file << render_prometheus())) {
+            return false;
+        }
+    }
+    return std::rename(temporary_path.c_str(), path.c_str()) == 0;
+}
+
+MetricsDumper::MetricsDumper(std::string path, int interval_ms)
+    : path_(std::move(path)), interval_ms_(interval_ms), thread_(&MetricsDumper::loop, this) {}
+
+MetricsDumper::~MetricsDumper() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    cv_.notify_all();
+    thread_.join();
+    Metrics::global().dump_to_file(path_);
+}
+
+void MetricsDumper::loop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!cv_.wait_for(lock, std::chrono::milliseconds(interval_ms_), [this] { return stopping_; })) {
+        lock.unlock();
+        Metrics::global().dump_to_file(path_);
+        lock.lock();
+    }
+}
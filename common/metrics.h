@@ -0,0 +1,310 @@
+#pragma once
+
+#include <atomic>             // For the per-thread cells and the enabled flag
+#include <chrono>             // For ScopedTimer
+#include <condition_variable> // For stopping MetricsDumper
+#include <cstddef>            // For size_t
+#include <cstdint>            // For uint64_t
+#include <memory>             // For std::unique_ptr shards
+#include <mutex>              // For registering metrics and threads
+#include <string>             // For names and the exported text
+#include <thread>             // For MetricsDumper
+#include <vector>             // For the metric definitions and shards
+
+// Low-overhead counters and latency histograms for hot paths, exported in the
+// Prometheus text format.
+//
+// Every thread that records a metric gets its own shard of cells the first
+// time it does so; from then on recording is a plain load and store on
+// memory no other thread writes, with no locks and no atomic read-modify-write
+// instructions. When the thread exits its shard goes back to a free list,
+// counts included, and the next new thread reuses it, so a server that
+// starts a thread per connection holds as many shards as it ever had threads
+// at once, not one per thread it ever started. Exporting sums the shards with relaxed loads, so an export
+// taken while threads are recording sees each cell either before or after an
+// update, never a torn value.
+//
+// Histograms are HDR-style log-linear: each power of two of nanoseconds is
+// split into 16 equal sub-buckets, so any recorded value is off by at most
+// 1/16 (6.25%) from the bucket that holds it, from 1 ns up to several hours,
+// in a fixed 656 buckets.
+//
+// Recording is off until set_enabled(true), so programs that never export
+// metrics do not pay for them; servers turn it on when asked to export.
+//
+//   Metrics::global().set_enabled(true);
+//   static const MetricHistogram run_time = Metrics::global().histogram("ort_run_seconds", "Session::Run time");
+//   {
+//       ScopedTimer timer(run_time);
+//       session.Run(...);
+//   }
+//   std::string text = Metrics::global().render_prometheus();
+
+class Metrics;
+
+// A monotonically increasing count, e.g. requests served.
+class MetricCounter {
+public:
+    void add(uint64_t amount = 1) const;
+    uint64_t value() const;
+
+private:
+    friend class Metrics;
+    MetricCounter(Metrics* metrics, size_t id) : metrics_(metrics), id_(id) {}
+    Metrics* metrics_;
+    size_t id_;
+};
+
+// Merged contents of one histogram across all threads.
+struct HistogramSnapshot {
+    std::vector<uint64_t> buckets; // Counts per log-linear bucket.
+    uint64_t count = 0;
+    uint64_t sum_ns = 0;
+
+    double mean_ns() const { return count == 0 ? 0.0 : static_cast<double>(sum_ns) / count; }
+    // Upper bound of the bucket holding the p-th percentile (0..100), in nanoseconds.
+    uint64_t percentile_ns(double p) const;
+
+    // Adds one value directly. Lets a single thread keep a fixed-size latency
+    // summary of its own, with the same buckets, whether or not Metrics is enabled.
+    void add_ns(uint64_t nanoseconds);
+};
+
+// A distribution of durations, recorded in nanoseconds and exported in seconds.
+class MetricHistogram {
+public:
+    void record_ns(uint64_t nanoseconds) const;
+    template <typename Duration>
+    void record(Duration duration) const {
+        record_ns(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count()));
+    }
+    HistogramSnapshot snapshot() const;
+
+private:
+    friend class Metrics;
+    MetricHistogram(Metrics* metrics, size_t id) : metrics_(metrics), id_(id) {}
+    Metrics* metrics_;
+    size_t id_;
+};
+
+// Process-wide metric registry.
+class Metrics {
+public:
+    static constexpr size_t kMaxCounters = 64;
+    static constexpr size_t kMaxHistograms = 16;
+    static constexpr size_t kSubBucketBits = 4;
+    static constexpr size_t kSubBuckets = size_t(1) << kSubBucketBits;
+    static constexpr size_t kMaxExponent = 44; // Values of 2^44 ns (about 4.9 hours) and up share the last bucket.
+    static constexpr size_t kBuckets = (kMaxExponent - kSubBucketBits + 1) * kSubBuckets;
+
+    static Metrics& global();
+
+    // Registers a metric, or returns the existing one with the same name.
+    // Throws std::length_error when kMaxCounters/kMaxHistograms are used up.
+    MetricCounter counter(const std::string& name, const std::string& help);
+    MetricHistogram histogram(const std::string& name, const std::string& help);
+
+    // Recording is skipped entirely while disabled (disabled by default).
+    void set_enabled(bool enabled) { enabled_.store(enabled, std::memory_order_relaxed); }
+    bool enabled() const { return enabled_.load(std::memory_order_relaxed); }
+
+    // All metrics in the Prometheus text exposition format (version 0.0.4).
+    std::string render_prometheus() const;
+
+    // Writes render_prometheus() to path atomically (temporary file + rename).
+    // Returns false if the file could not be written.
+    bool dump_to_file(const std::string& path) const;
+
+    // Log-linear bucket of a value, and the smallest value of a bucket.
+    static size_t bucket_index(uint64_t nanoseconds);
+    static uint64_t bucket_lower_bound(size_t index);
+
+private:
+    friend class MetricCounter;
+    friend class MetricHistogram;
+
+    struct HistogramCells {
+        std::atomic<uint64_t> buckets[kBuckets];
+        std::atomic<uint64_t> count;
+        std::atomic<uint64_t> sum_ns;
+    };
+
+    // One thread's cells, written only by that thread. Shards outlive their
+    // threads so counts recorded by finished threads are still exported.
+    struct Shard {
+        std::atomic<uint64_t> counters[kMaxCounters];
+        HistogramCells histograms[kMaxHistograms];
+    };
+
+    // A thread's claim on its shard; returns the shard to the free list when the thread exits.
+    struct ShardLease {
+        Shard* shard = nullptr;
+        ~ShardLease() {
+            if (shard != nullptr) {
+                Metrics::global().release_shard(shard);
+            }
+        }
+    };
+
+    struct Definition {
+        std::string name;
+        std::string help;
+    };
+
+    Metrics() = default;
+    Shard& local_shard();
+    Shard& register_shard();
+    void release_shard(Shard* shard);
+    std::vector<const Shard*> shards_snapshot() const;
+    uint64_t counter_value(size_t id) const;
+    HistogramSnapshot histogram_snapshot(size_t id) const;
+
+    // Single-writer increment: the owning thread is the only one storing to the cell.
+    static void bump(std::atomic<uint64_t>& cell, uint64_t amount) {
+        cell.store(cell.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+    }
+
+    std::atomic<bool> enabled_{false};
+    mutable std::mutex mutex_; // Protects the definitions and the shard lists.
+    std::vector<Definition> counters_;
+    std::vector<Definition> histograms_;
+    std::vector<std::unique_ptr<Shard>> shards_;
+    std::vector<Shard*> free_shards_; // Shards of exited threads, waiting for a new owner.
+};
+
+inline void MetricCounter::add(uint64_t amount) const {
+    if (metrics_->enabled()) {
+        Metrics::bump(metrics_->local_shard().counters[id_], amount);
+    }
+}
+
+inline uint64_t MetricCounter::value() const {
+    return metrics_->counter_value(id_);
+}
+
+inline void MetricHistogram::record_ns(uint64_t nanoseconds) const {
+    if (!metrics_->enabled()) {
+        return;
+    }
+    Metrics::HistogramCells& cells = metrics_->local_shard().histograms[id_];
+    Metrics::bump(cells.buckets[Metrics::bucket_index(nanoseconds)], 1);
+    Metrics::bump(cells.count, 1);
+    Metrics::bump(cells.sum_ns, nanoseconds);
+}
+
+inline void HistogramSnapshot::add_ns(uint64_t nanoseconds) {
+    if (buckets.empty()) {
+        buckets.assign(Metrics::kBuckets, 0);
+    }
+    ++buckets[Metrics::bucket_index(nanoseconds)];
+    ++count;
+    sum_ns += nanoseconds;
+}
+
+inline HistogramSnapshot MetricHistogram::snapshot() const {
+    return metrics_->histogram_snapshot(id_);
+}
+
+inline Metrics::Shard& Metrics::local_shard() {
+    // Metrics only exists as global(), so one lease per thread is enough.
+    thread_local ShardLease lease;
+    if (lease.shard == nullptr) {
+        lease.shard = &register_shard();
+    }
+    return *lease.shard;
+}
+
+inline size_t Metrics::bucket_index(uint64_t nanoseconds) {
+    if (nanoseconds < kSubBuckets) {
+        return static_cast<size_t>(nanoseconds);
+    }
+#if defined(__GNUC__) || defined(__clang__)
+    size_t exponent = 63 - static_cast<size_t>(__builtin_clzll(nanoseconds));
+#else
+    size_t exponent = 0;
+    for (uint64_t v = nanoseconds; v > 1; v >>= 1) {
+        ++exponent;
+    }
+#endif
+    if (exponent >= kMaxExponent) {
+        return kBuckets - 1;
+    }
+    size_t sub_bucket = static_cast<size_t>(nanoseconds >> (exponent - kSubBucketBits)) & (kSubBuckets - 1);
+    return (exponent - kSubBucketBits + 1) * kSubBuckets + sub_bucket;
+}
+
+// Records the time from construction to destruction into a histogram. Reads
+// no clock at all while metrics are disabled.
+class ScopedTimer {
+public:
+    explicit ScopedTimer(const MetricHistogram& histogram)
+        : histogram_(histogram), active_(Metrics::global().enabled()) {
+        if (active_) {
+            begin_ = std::chrono::steady_clock::now();
+        }
+    }
+    ~ScopedTimer() {
+        if (active_) {
+            histogram_.record(std::chrono::steady_clock::now() - begin_);
+        }
+    }
+
+    ScopedTimer(const ScopedTimer&) = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+private:
+    MetricHistogram histogram_; // A copy, so timing into a temporary handle is safe.
+    bool active_;
+    std::chrono::steady_clock::time_point begin_;
+};
+
+// Times consecutive stages with one clock read per stage instead of two:
+// each lap() records the time since the previous lap (or construction).
+//
+//   StageTimer stages;
+//   create_tensors();
+//   stages.lap(tensor_create_time);
+//   session.Run(...);
+//   stages.lap(run_time);
+class StageTimer {
+public:
+    StageTimer() : active_(Metrics::global().enabled()) {
+        if (active_) {
+            last_ = std::chrono::steady_clock::now();
+        }
+    }
+
+    void lap(const MetricHistogram& histogram) {
+        if (active_) {
+            auto now = std::chrono::steady_clock::now();
+            histogram.record(now - last_);
+            last_ = now;
+        }
+    }
+
+private:
+    bool active_;
+    std::chrono::steady_clock::time_point last_;
+};
+
+// Writes Metrics::global() to a file every interval_ms on a background thread,
+// and once more when stopped, so a scraper (e.g. node_exporter's textfile
+// collector) or a human can read it while the process runs.
+class MetricsDumper {
+public:
+    MetricsDumper(std::string path, int interval_ms);
+    ~MetricsDumper();
+
+    MetricsDumper(const MetricsDumper&) = delete;
+    MetricsDumper& operator=(const MetricsDumper&) = delete;
+
+private:
+    void loop();
+
+    std::string path_;
+    int interval_ms_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    bool stopping_ = false;
+    std::thread thread_;
+};
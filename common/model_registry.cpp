@@ -0,0 +1,194 @@
+#include "model_registry.h"
+
+#include <algorithm> // For std::max
+#include <fstream>   // For the model file size
+#include <iterator>  // For std::next
+#include <stdexcept> // For std::out_of_range
+#include <utility>   // For std::move
+
+#include "process_stats.h" // For current_rss_bytes
+
+namespace {
+
+size_t file_size(const std::string& path) {
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    return file ? static_cast<size_t>(file.tellg()) : 0;
+}
+
+} // namespace
+
+Ort::Env ModelRegistry::create_env(const ModelRegistryOptions& options) {
+    if (!options.use_global_thread_pool) {
+        return Ort::Env(ORT_LOGGING_LEVEL_WARNING, "model_registry");
+    }
+    Ort::ThreadingOptions threading_options;
+    threading_options.SetGlobalIntraOpNumThreads(options.intra_op_threads);
+    threading_options.SetGlobalInterOpNumThreads(options.inter_op_threads);
+    threading_options.SetGlobalSpinControl(options.allow_spinning ? 1 : 0);
+    return Ort::Env(threading_options, ORT_LOGGING_LEVEL_WARNING, "model_registry");
+}
+
+ModelRegistry::ModelRegistry(const ModelRegistryOptions& options)
+    : options_(options), env_(create_env(options)) {
+    // --- Optional shared arena: every session allocates from one Env-level CPU arena ---
+    if (options_.use_env_allocator) {
+        Ort::MemoryInfo memory_info("Cpu", OrtArenaAllocator, 0, OrtMemTypeDefault);
+        Ort::ArenaCfg arena_cfg(options_.arena_max_bytes, -1, -1, -1);
+        env_.CreateAndRegisterAllocator(memory_info, arena_cfg);
+        session_options_.AddConfigEntry("session.use_env_allocators", "1");
+    }
+
+    // --- Session options shared by every model ---
+    session_options_.SetGraphOptimizationLevel(options_.optimization_level);
+    if (options_.use_global_thread_pool) {
+        session_options_.DisablePerSessionThreads();
+    } else {
+        session_options_.SetIntraOpNumThreads(options_.intra_op_threads);
+        session_options_.SetInterOpNumThreads(options_.inter_op_threads);
+        const char* spinning = options_.allow_spinning ? "1" : "0";
+        session_options_.AddConfigEntry("session.intra_op.allow_spinning", spinning);
+        session_options_.AddConfigEntry("session.inter_op.allow_spinning", spinning);
+    }
+}
+
+void ModelRegistry::add(const std::string& name, const std::string& model_path) {
+    std::shared_ptr<Ort::Session> retired; // Destroyed after the lock is released.
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto inserted = entries_.emplace(name, Entry());
+    Entry& entry = inserted.first->second;
+    if (!inserted.second && entry.session && entry.path != model_path) {
+        retired = unload_entry(entry); // Re-pointed: the next get() loads the new file.
+    }
+    entry.path = model_path;
+    stats_.registered = entries_.size();
+}
+
+std::shared_ptr<Ort::Session> ModelRegistry::get(const std::string& name) {
+    // --- Fast path: already loaded ---
+    std::string path;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = entries_.find(name);
+        if (it == entries_.end()) {
+            throw std::out_of_range("unknown model: " + name);
+        }
+        Entry& entry = it->second;
+        if (entry.session) {
+            lru_.splice(lru_.begin(), lru_, entry.lru_position);
+            ++stats_.hits;
+            return entry.session;
+        }
+        path = entry.path;
+    }
+
+    // --- Slow path: load outside mutex_ so other models keep serving ---
+    std::lock_guard<std::mutex> load_lock(load_mutex_);
+    {
+        // Another thread may have loaded it while this one waited for load_mutex_.
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = entries_.find(name);
+        if (it != entries_.end() && it->second.session) {
+            lru_.splice(lru_.begin(), lru_, it->second.lru_position);
+            ++stats_.hits;
+            return it->second.session;
+        }
+        if (it != entries_.end()) {
+            path = it->second.path;
+        }
+    }
+    // add() may re-point the name while its old file is loading; that session
+    // is then dropped and the new file loaded instead.
+    while (true) {
+        size_t rss_before = current_rss_bytes();
+        auto session = std::make_shared<Ort::Session>(env_, path.c_str(), session_options_);
+        size_t rss_after = current_rss_bytes();
+        size_t estimated_bytes = std::max(rss_after > rss_before ? rss_after - rss_before : 0, file_size(path));
+
+        // Evicted or stale sessions are destroyed after mutex_ is released (declared before the lock).
+        std::vector<std::shared_ptr<Ort::Session>> retired;
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = entries_.find(name);
+        if (it == entries_.end()) {
+            throw std::out_of_range("unknown model: " + name);
+        }
+        Entry& entry = it->second;
+        if (entry.path != path) {
+            path = entry.path;
+            retired.push_back(std::move(session));
+            continue;
+        }
+        entry.session = session;
+        entry.estimated_bytes = estimated_bytes;
+        lru_.push_front(name);
+        entry.lru_position = lru_.begin();
+        ++stats_.loads;
+        ++stats_.loaded;
+        stats_.resident_bytes += estimated_bytes;
+        evict_to_budget(name, retired);
+        return session;
+    }
+}
+
+bool ModelRegistry::unload(const std::string& name) {
+    std::shared_ptr<Ort::Session> retired; // Destroyed after the lock is released.
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(name);
+    if (it == entries_.end() || !it->second.session) {
+        return false;
+    }
+    retired = unload_entry(it->second);
+    return true;
+}
+
+void ModelRegistry::evict_to_budget(const std::string& keep, std::vector<std::shared_ptr<Ort::Session>>& retired) {
+    if (options_.memory_budget_bytes == 0) {
+        return;
+    }
+    // Walk from the least recently used end; the model just loaded is never evicted.
+    auto position = lru_.end();
+    while (stats_.resident_bytes > options_.memory_budget_bytes && position != lru_.begin()) {
+        --position;
+        if (*position == keep) {
+            continue;
+        }
+        Entry& victim = entries_.at(*position);
+        auto next = std::next(position);
+        retired.push_back(unload_entry(victim));
+        ++stats_.evictions;
+        position = next;
+    }
+}
+
+std::shared_ptr<Ort::Session> ModelRegistry::unload_entry(Entry& entry) {
+    lru_.erase(entry.lru_position);
+    stats_.resident_bytes -= entry.estimated_bytes;
+    entry.estimated_bytes = 0;
+    --stats_.loaded;
+    return std::move(entry.session);
+}
+
+bool ModelRegistry::contains(const std::string& name) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return entries_.count(name) != 0;
+}
+
+bool ModelRegistry::is_loaded(const std::string& name) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(name);
+    return it != entries_.end() && it->second.session != nullptr;
+}
+
+std::vector<std::string> ModelRegistry::names() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<std::string> result;
+    result.reserve(entries_.size());
+    for (const auto& entry : entries_) {
+        result.push_back(entry.first);
+    }
+    return result;
+}
+
+ModelRegistryStats ModelRegistry::stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
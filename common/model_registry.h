@@ -0,0 +1,112 @@
+#pragma once
+
+#include <cstddef>       // For size_t
+#include <list>          // For the LRU order
+#include <memory>        // For std::shared_ptr sessions
+#include <mutex>         // For protecting the registry
+#include <string>        // For model names and paths
+#include <unordered_map> // For the name lookup
+#include <vector>        // For listing names
+
+// ONNX Runtime C++ API header file
+#include <onnxruntime_cxx_api.h>
+
+// Settings shared by every model in a ModelRegistry.
+struct ModelRegistryOptions {
+    // Global thread pools owned by the Env and shared by all sessions
+    // (DisablePerSessionThreads). Without them every session starts its own
+    // intra_op_threads/inter_op_threads threads.
+    bool use_global_thread_pool = true;
+    int intra_op_threads = 0;    // 0 = ORT default (one per core).
+    int inter_op_threads = 1;
+    bool allow_spinning = false; // Mostly idle models should not keep cores busy.
+
+    // One CPU arena registered on the Env for every session instead of one per session.
+    bool use_env_allocator = true;
+    size_t arena_max_bytes = 0;  // 0 = no limit.
+
+    // Estimated bytes the loaded models may use together; above it the least
+    // recently used models are unloaded. 0 = no limit.
+    size_t memory_budget_bytes = 0;
+
+    GraphOptimizationLevel optimization_level = ORT_ENABLE_ALL;
+};
+
+// Counters describing what the registry has done so far.
+struct ModelRegistryStats {
+    size_t registered = 0;     // Names known to the registry.
+    size_t loaded = 0;         // Models currently loaded.
+    size_t resident_bytes = 0; // Sum of the loaded models' estimated sizes.
+    size_t hits = 0;           // get() calls served by an already loaded model.
+    size_t loads = 0;          // Models loaded (first use, or again after eviction).
+    size_t evictions = 0;      // Models unloaded to stay within the budget.
+};
+
+// Hosts many models in one process under a single Ort::Env.
+//
+// Models are registered by name and loaded on first use. All sessions share
+// the Env's global intra-op/inter-op thread pools and its CPU arena, so adding
+// a model adds its weights and graph but no threads and no extra arena. When
+// memory_budget_bytes is set, loading a model unloads the least recently used
+// ones until the estimated total fits again.
+//
+//   ModelRegistry registry(options);
+//   registry.add("linear", "data/linear/linear.onnx");
+//   std::shared_ptr<Ort::Session> session = registry.get("linear");
+//
+// get() returns a shared_ptr, so a model evicted while a request is using it
+// stays alive until that request drops it. A model's size is estimated as the
+// growth in process RSS while its session was created, and at least its file
+// size. All member functions are thread-safe.
+class ModelRegistry {
+public:
+    explicit ModelRegistry(const ModelRegistryOptions& options = ModelRegistryOptions());
+
+    ModelRegistry(const ModelRegistry&) = delete;
+    ModelRegistry& operator=(const ModelRegistry&) = delete;
+
+    // Registers (or re-points) a model name. The file is not read until get().
+    // A get() that is loading the old file at the time discards it and loads the new one.
+    void add(const std::string& name, const std::string& model_path);
+
+    // The session for `name`, loading it (and evicting others) if needed.
+    // Throws std::out_of_range for unknown names and Ort::Exception if loading fails.
+    std::shared_ptr<Ort::Session> get(const std::string& name);
+
+    // Unloads a model now; it is loaded again on the next get(). Returns false if it was not loaded.
+    bool unload(const std::string& name);
+
+    bool contains(const std::string& name) const;
+    bool is_loaded(const std::string& name) const;
+    std::vector<std::string> names() const;
+    ModelRegistryStats stats() const;
+
+    Ort::Env& env() { return env_; }
+    const ModelRegistryOptions& options() const { return options_; }
+
+private:
+    struct Entry {
+        std::string path;
+        std::shared_ptr<Ort::Session> session; // Null while not loaded.
+        size_t estimated_bytes = 0;
+        std::list<std::string>::iterator lru_position; // Valid while loaded.
+    };
+
+    static Ort::Env create_env(const ModelRegistryOptions& options);
+    // Unloads least recently used models other than `keep` until the budget
+    // holds, handing their sessions to `retired`. Needs mutex_.
+    void evict_to_budget(const std::string& keep, std::vector<std::shared_ptr<Ort::Session>>& retired);
+    // Takes a loaded entry's session out of the registry and returns it, so the
+    // caller can destroy it outside mutex_. Needs mutex_.
+    std::shared_ptr<Ort::Session> unload_entry(Entry& entry);
+
+    ModelRegistryOptions options_;
+    Ort::Env env_;
+    Ort::SessionOptions session_options_;
+
+    mutable std::mutex mutex_;   // Protects everything below.
+    std::mutex load_mutex_;      // One load at a time, so RSS growth can be attributed to it.
+    std::unordered_map<std::string, Entry> entries_;
+    std::list<std::string> lru_; // Most recently used first.
+    ModelRegistryStats stats_;
+};
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstddef> // For size_t
+#include <fstream> // For reading /proc/self
+#include <string>  // For parsing /proc/self/status
+
+#include <unistd.h> // For sysconf
+
+// Current (not peak) resource usage of this process, read from /proc on Linux.
+// getrusage only reports peak RSS, which never goes down when memory is freed.
+// Both functions return 0 where /proc is not available.
+
+// Resident set size in bytes.
+inline size_t current_rss_bytes() {
+    std::ifstream statm("/proc/self/statm");
+    size_t total_pages = 0;
+    size_t resident_pages = 0;
+    if (!(statm >> total_pages >> resident_pages)) {
+        return 0;
+    }
+    return resident_pages * static_cast<size_t>(sysconf(_SC_PAGESIZE));
+}
+
+// Proportional set size in bytes: like RSS, but each page shared with other
+// processes (e.g. a memory-mapped model file) counts as 1/N of a page for each
+// of the N processes sharing it. Needs Linux 4.14+ for smaps_rollup.
+inline size_t current_pss_bytes() {
+    std::ifstream rollup("/proc/self/smaps_rollup");
+    std::string line;
+    while (std::getline(rollup, line)) {
+        if (line.compare(0, 4, "Pss:") == 0) {
+            return static_cast<size_t>(std::stoul(line.substr(4))) * 1024; // Reported in kB.
+        }
+    }
+    return 0;
+}
+
+// Number of threads in the process, including the calling one.
+inline size_t current_thread_count() {
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line)) {
+        if (line.compare(0, 8, "Threads:") == 0) {
+            return static_cast<size_t>(std::stoul(line.substr(8)));
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <fstream>   // For reading/writing the config file
+#include <stdexcept> // For std::runtime_error
+#include <string>    // For std::string
+#include <vector>    // For the candidate list
+
+// ONNX Runtime C++ API header file
+#include <onnxruntime_cxx_api.h>
+
+// Selecting and persisting an execution provider (EP) choice.
+//
+// available_providers benchmarks the CPU-capable providers on a model and
+// writes the fastest one to a small "key=value" file:
+//
+//   model=data/linear/linear.onnx
+//   batch_size=256
+//   provider=XNNPACK
+//
+// Serving programs read that file at startup and call append_provider() on
+// their session options instead of always using the default CPU provider.
+
+struct ProviderConfig {
+    std::string model;
+    long batch_size = 0;
+    std::string provider = "CPU";
+};
+
+// Short provider names accepted by append_provider(), with the name that
+// Ort::GetAvailableProviders() reports for each.
+struct ProviderCandidate {
+    const char* name;
+    const char* ort_name;
+};
+
+inline const std::vector<ProviderCandidate>& cpu_provider_candidates() {
+    static const std::vector<ProviderCandidate> candidates = {
+        {"CPU", "CPUExecutionProvider"},
+        {"XNNPACK", "XnnpackExecutionProvider"},
+        {"DNNL", "DnnlExecutionProvider"},
+        {"OpenVINO", "OpenVINOExecutionProvider"},
+    };
+    return candidates;
+}
+
+// Registers the named provider on the session options. "CPU" needs nothing,
+// since ORT always falls back to the CPU provider for unsupported nodes.
+// Throws Ort::Exception (or std::runtime_error) if the provider is unavailable.
+inline void append_provider(Ort::SessionOptions& session_options, const std::string& name) {
+    if (name == "CPU") {
+        return;
+    }
+    if (name == "XNNPACK") {
+        session_options.AppendExecutionProvider("XNNPACK", {});
+    } else if (name == "OpenVINO") {
+        session_options.AppendExecutionProvider("OpenVINO", {{"device_type", "CPU"}});
+    } else if (name == "DNNL") {
+#if ORT_API_VERSION >= 15
+        const OrtApi& api = Ort::GetApi();
+        OrtDnnlProviderOptions* dnnl_options = nullptr;
+        Ort::ThrowOnError(api.CreateDnnlProviderOptions(&dnnl_options));
+        OrtStatus* status = api.SessionOptionsAppendExecutionProvider_Dnnl(session_options, dnnl_options);
+        api.ReleaseDnnlProviderOptions(dnnl_options);
+        Ort::ThrowOnError(status);
+#else
+        throw std::runtime_error("DNNL provider options need ONNX Runtime 1.15 or newer");
+#endif
+    } else {
+        throw std::runtime_error("unknown execution provider: " + name);
+    }
+}
+
+inline void save_provider_config(const std::string& path, const ProviderConfig& config) {
+    std::ofstream file(path);
+    if (!file) {
+        throw std::runtime_error("cannot write provider config: " + path);
+    }
+    file << "# Written by available_providers\n"
+         << "model=" << config.model << "\n"
+         << "batch_size=" << config.batch_size << "\n"
+         << "provider=" << config.provider << "\n";
+}
+
+inline ProviderConfig load_provider_config(const std::string& path) {
+    std::ifstream file(path);
+    if (!file) {
+        throw std::runtime_error("cannot read provider config: " + path);
+    }
+    ProviderConfig config;
+    std::string line;
+    while (std::getline(file, line)) {
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+        size_t equals = line.find('=');
+        if (equals == std::string::npos) {
+            continue;
+        }
+        std::string key = line.substr(0, equals);
+        std::string value = line.substr(equals + 1);
+        if (key == "model") {
+            config.model = value;
+        } else if (key == "batch_size") {
+            config.batch_size = std::stol(value);
+        } else if (key == "provider") {
+            config.provider = value;
+        }
+    }
+    return config;
+}
@@ -0,0 +1,240 @@
+#include "result_cache.h"
+
+#include <algorithm> // For std::copy, std::max
+#include <cstring>   // For std::memcpy, std::memcmp
+#include <iterator>  // For std::prev
+#include <stdexcept> // For std::invalid_argument
+
+#include "metrics.h" // For the hit/miss counters
+
+namespace {
+
+// List node, map node and vector headers of one entry, added to its data size.
+constexpr size_t kEntryOverheadBytes = 128;
+
+struct CacheMetrics {
+    MetricCounter hits = Metrics::global().counter(
+        "result_cache_hits_total", "Inputs answered from a ResultCache");
+    MetricCounter misses = Metrics::global().counter(
+        "result_cache_misses_total", "Inputs not found in a ResultCache");
+    MetricCounter evictions = Metrics::global().counter(
+        "result_cache_evictions_total", "ResultCache entries evicted to stay within the size limits");
+};
+
+const CacheMetrics& cache_metrics() {
+    static const CacheMetrics metrics;
+    return metrics;
+}
+
+// Finalizer of splitmix64: spreads every input bit over the whole word.
+uint64_t mix(uint64_t value) {
+    value ^= value >> 30;
+    value *= 0xbf58476d1ce4e5b9ULL;
+    value ^= value >> 27;
+    value *= 0x94d049bb133111ebULL;
+    value ^= value >> 31;
+    return value;
+}
+
+// Product of the static dimensions, and how many dynamic ones there are. The
+// dynamic one (if any) is the row count.
+size_t static_elements(const std::vector<int64_t>& shape, size_t* dynamic_count) {
+    size_t elements = 1;
+    *dynamic_count = 0;
+    for (int64_t dim : shape) {
+        if (dim == -1) {
+            ++*dynamic_count;
+        } else {
+            elements *= static_cast<size_t>(dim);
+        }
+    }
+    return elements;
+}
+
+// Splits a limit evenly over the shards, rounding up; 0 stays "no limit".
+size_t per_shard(size_t limit, size_t shards) {
+    return limit == 0 ? 0 : std::max<size_t>(1, (limit + shards - 1) / shards);
+}
+
+} // namespace
+
+ResultCache::ResultCache(const ResultCacheOptions& options)
+    : options_(options),
+      shard_max_entries_(per_shard(options.max_entries, std::max<size_t>(1, options.shards))),
+      shard_max_bytes_(per_shard(options.max_bytes, std::max<size_t>(1, options.shards))) {
+    options_.shards = std::max<size_t>(1, options_.shards);
+    for (size_t s = 0; s < options_.shards; ++s) {
+        shards_.push_back(std::unique_ptr<Shard>(new Shard()));
+    }
+}
+
+uint64_t ResultCache::hash(Span<const float> input) {
+    // Eight bytes at a time, so a row of N floats costs about N/2 multiplies.
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(input.data());
+    size_t size = input.size() * sizeof(float);
+    uint64_t hash = mix(size);
+    size_t offset = 0;
+    for (; offset + sizeof(uint64_t) <= size; offset += sizeof(uint64_t)) {
+        uint64_t word;
+        std::memcpy(&word, bytes + offset, sizeof(word));
+        hash = mix(hash ^ word);
+    }
+    if (offset < size) {
+        uint64_t word = 0;
+        std::memcpy(&word, bytes + offset, size - offset);
+        hash = mix(hash ^ word);
+    }
+    return hash;
+}
+
+ResultCache::Shard& ResultCache::shard_for(uint64_t input_hash) const {
+    // The high bits pick the shard; the shard's unordered_map uses the low ones.
+    return *shards_[(input_hash >> 32) % shards_.size()];
+}
+
+bool ResultCache::lookup(uint64_t input_hash, Span<const float> input, Span<float> output) {
+    Shard& shard = shard_for(input_hash);
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto found = shard.index.find(input_hash);
+        if (found != shard.index.end()) {
+            const Entry& entry = *found->second;
+            if (entry.input.size() == input.size() && entry.output.size() == output.size() &&
+                std::memcmp(entry.input.data(), input.data(), input.size() * sizeof(float)) == 0) {
+                shard.lru.splice(shard.lru.begin(), shard.lru, found->second);
+                std::copy(entry.output.begin(), entry.output.end(), output.data());
+                ++shard.hits;
+                cache_metrics().hits.add();
+                return true;
+            }
+        }
+        ++shard.misses;
+    }
+    cache_metrics().misses.add();
+    return false;
+}
+
+void ResultCache::insert(uint64_t input_hash, Span<const float> input, Span<const float> output) {
+    size_t entry_bytes = (input.size() + output.size()) * sizeof(float) + kEntryOverheadBytes;
+    if (shard_max_bytes_ != 0 && entry_bytes > shard_max_bytes_) {
+        return;
+    }
+    // Copy the rows before taking the lock; evicted entries are freed after releasing it.
+    Entry entry{input_hash, std::vector<float>(input.begin(), input.end()),
+                std::vector<float>(output.begin(), output.end()), entry_bytes};
+    std::list<Entry> retired;
+    size_t evicted = 0;
+    Shard& shard = shard_for(input_hash);
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto found = shard.index.find(input_hash);
+        if (found != shard.index.end()) {
+            // Same input inserted twice (two threads missed at once), or a collision: keep the newest.
+            shard.bytes -= found->second->bytes;
+            retired.splice(retired.end(), shard.lru, found->second);
+            shard.index.erase(found);
+        }
+        shard.lru.push_front(std::move(entry));
+        shard.index.emplace(input_hash, shard.lru.begin());
+        shard.bytes += entry_bytes;
+        ++shard.insertions;
+
+        while (shard.lru.size() > 1 &&
+               ((shard_max_entries_ != 0 && shard.lru.size() > shard_max_entries_) ||
+                (shard_max_bytes_ != 0 && shard.bytes > shard_max_bytes_))) {
+            auto oldest = std::prev(shard.lru.end());
+            shard.bytes -= oldest->bytes;
+            shard.index.erase(oldest->hash);
+            retired.splice(retired.end(), shard.lru, oldest);
+            ++evicted;
+        }
+        shard.evictions += evicted;
+    }
+    if (evicted != 0) {
+        cache_metrics().evictions.add(evicted);
+    }
+}
+
+void ResultCache::clear() {
+    for (auto& shard : shards_) {
+        std::list<Entry> retired;
+        std::lock_guard<std::mutex> lock(shard->mutex);
+        retired.swap(shard->lru);
+        shard->index.clear();
+        shard->bytes = 0;
+    }
+}
+
+ResultCacheStats ResultCache::stats() const {
+    ResultCacheStats stats;
+    for (const auto& shard : shards_) {
+        std::lock_guard<std::mutex> lock(shard->mutex);
+        stats.hits += shard->hits;
+        stats.misses += shard->misses;
+        stats.insertions += shard->insertions;
+        stats.evictions += shard->evictions;
+        stats.entries += shard->lru.size();
+        stats.bytes += shard->bytes;
+    }
+    return stats;
+}
+
+CachedRunner::CachedRunner(InferenceRunner& runner, ResultCache& cache)
+    : runner_(runner), cache_(cache), batched_(false) {
+    if (runner_.input_count() != 1 || runner_.output_count() != 1 ||
+        runner_.inputs()[0].type != ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT ||
+        runner_.outputs()[0].type != ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT) {
+        throw std::invalid_argument("CachedRunner needs a model with one float input and one float output");
+    }
+    size_t input_dynamic = 0;
+    size_t output_dynamic = 0;
+    input_row_size_ = static_elements(runner_.inputs()[0].shape, &input_dynamic);
+    output_row_size_ = static_elements(runner_.outputs()[0].shape, &output_dynamic);
+    // With two dynamic dimensions (e.g. [batch, sequence]) a row's size is not
+    // fixed, so rows could not be split out of a batch or compared by size.
+    if (input_dynamic > 1 || output_dynamic > 1) {
+        throw std::invalid_argument("CachedRunner needs at most one dynamic dimension in the input and the output");
+    }
+    if (input_dynamic != output_dynamic || input_row_size_ == 0) {
+        throw std::invalid_argument("CachedRunner needs the input and output to share one dynamic batch dimension");
+    }
+    batched_ = input_dynamic == 1;
+}
+
+Span<const float> CachedRunner::run(Span<const float> input) {
+    if (input.size() % input_row_size_ != 0 || (!batched_ && input.size() != input_row_size_)) {
+        throw std::invalid_argument("input size does not fit the model's input shape");
+    }
+    size_t rows = input.size() / input_row_size_;
+    output_.resize(rows * output_row_size_);
+    miss_input_.clear();
+    miss_rows_.clear();
+    miss_hashes_.clear();
+
+    // --- 1. Answer what we can from the cache and collect the misses ---
+    for (size_t r = 0; r < rows; ++r) {
+        Span<const float> row(input.data() + r * input_row_size_, input_row_size_);
+        uint64_t row_hash = ResultCache::hash(row);
+        if (!cache_.lookup(row_hash, row, Span<float>(output_.data() + r * output_row_size_, output_row_size_))) {
+            miss_input_.insert(miss_input_.end(), row.begin(), row.end());
+            miss_rows_.push_back(r);
+            miss_hashes_.push_back(row_hash);
+        }
+    }
+
+    // --- 2. Run only the misses, as one smaller batch, and remember their results ---
+    if (!miss_rows_.empty()) {
+        Span<const float> computed = runner_.run(miss_input_);
+        if (computed.size() != miss_rows_.size() * output_row_size_) {
+            throw std::invalid_argument("model output does not have one row per input row");
+        }
+        for (size_t m = 0; m < miss_rows_.size(); ++m) {
+            Span<const float> result(computed.data() + m * output_row_size_, output_row_size_);
+            std::copy(result.begin(), result.end(), output_.data() + miss_rows_[m] * output_row_size_);
+            cache_.insert(miss_hashes_[m],
+                          Span<const float>(miss_input_.data() + m * input_row_size_, input_row_size_), result);
+        }
+    }
+    last_rows_ = rows;
+    return Span<const float>(output_.data(), output_.size());
+}
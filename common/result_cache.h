@@ -0,0 +1,144 @@
+#pragma once
+
+#include <cstddef>       // For size_t
+#include <cstdint>       // For uint64_t hashes
+#include <list>          // For the LRU order
+#include <memory>        // For std::unique_ptr shards
+#include <mutex>         // For the per-shard locks
+#include <unordered_map> // For the hash lookup
+#include <vector>        // For the stored rows and the miss batch
+
+#include "inference_runner.h"
+#include "span.h"
+
+// Size limits and sharding of a ResultCache.
+struct ResultCacheOptions {
+    size_t shards = 16;              // Independently locked parts; more shards, less lock contention.
+    size_t max_entries = 1 << 16;    // 0 = no limit.
+    size_t max_bytes = 64u << 20;    // Estimated bytes of keys, values and bookkeeping. 0 = no limit.
+};
+
+// What a ResultCache has done so far, summed over its shards.
+struct ResultCacheStats {
+    size_t hits = 0;
+    size_t misses = 0;
+    size_t insertions = 0;
+    size_t evictions = 0; // Entries dropped to stay within the limits.
+    size_t entries = 0;   // Entries held now.
+    size_t bytes = 0;     // Estimated bytes held now.
+
+    double hit_rate() const { return hits + misses == 0 ? 0.0 : static_cast<double>(hits) / (hits + misses); }
+};
+
+// Memoizes model outputs for inputs that were seen before.
+//
+// Entries are keyed by a 64-bit hash of the input's bytes and also keep the
+// input itself, so a hash collision is a miss, never a wrong answer. Inputs
+// that differ in any bit (0.0f and -0.0f, two NaN payloads) are different
+// keys. The cache is split into shards chosen by the hash, each with its own
+// lock and its own least-recently-used list, so threads working on different
+// inputs rarely wait for each other. Each shard gets an equal part of
+// max_entries and max_bytes and evicts its least recently used entries when
+// it goes over.
+//
+// Only a deterministic model may be cached, and the cache must be cleared (or
+// replaced) whenever the model changes. While Metrics::global() is enabled,
+// hits, misses and evictions are also counted in its result_cache_* counters
+// (metrics.h).
+// All member functions are thread-safe.
+class ResultCache {
+public:
+    explicit ResultCache(const ResultCacheOptions& options = ResultCacheOptions());
+
+    ResultCache(const ResultCache&) = delete;
+    ResultCache& operator=(const ResultCache&) = delete;
+
+    static uint64_t hash(Span<const float> input);
+
+    // Copies the cached output for `input` into `output` and returns true, or
+    // returns false if there is none (or it has a different size than `output`).
+    bool lookup(Span<const float> input, Span<float> output) { return lookup(hash(input), input, output); }
+    bool lookup(uint64_t input_hash, Span<const float> input, Span<float> output);
+
+    // Stores a copy of `output` as the result for `input`, replacing any entry
+    // with the same hash. An entry larger than a whole shard's budget is not stored.
+    void insert(Span<const float> input, Span<const float> output) { insert(hash(input), input, output); }
+    void insert(uint64_t input_hash, Span<const float> input, Span<const float> output);
+
+    void clear();
+    ResultCacheStats stats() const;
+    const ResultCacheOptions& options() const { return options_; }
+
+private:
+    struct Entry {
+        uint64_t hash;
+        std::vector<float> input;
+        std::vector<float> output;
+        size_t bytes;
+    };
+
+    // Padded to a cache line so neighbouring shards' locks don't false-share.
+    struct alignas(64) Shard {
+        std::mutex mutex;
+        std::list<Entry> lru; // Most recently used first.
+        std::unordered_map<uint64_t, std::list<Entry>::iterator> index;
+        size_t bytes = 0;
+        size_t hits = 0;
+        size_t misses = 0;
+        size_t insertions = 0;
+        size_t evictions = 0;
+    };
+
+    Shard& shard_for(uint64_t input_hash) const;
+
+    ResultCacheOptions options_;
+    size_t shard_max_entries_;
+    size_t shard_max_bytes_;
+    std::vector<std::unique_ptr<Shard>> shards_;
+};
+
+// Runs an InferenceRunner through a ResultCache, one row at a time.
+//
+// A batch is split along the model's dynamic (batch) dimension into rows.
+// Rows found in the cache are copied straight to the output; only the misses
+// are packed into one smaller batch for runner.run(), and their results are
+// scattered back into place and added to the cache. A batch made entirely of
+// hits does not call Run at all. A model without a dynamic dimension is
+// cached as a single row.
+//
+//   ResultCache cache;                  // Shared by all threads.
+//   CachedRunner cached(runner, cache); // One per thread, like the runner.
+//   Span<const float> output = cached.run(input);
+//
+// Like InferenceRunner, a CachedRunner is not thread-safe.
+class CachedRunner {
+public:
+    // Both must outlive the CachedRunner. Throws std::invalid_argument unless
+    // the model has one float input and one float output with at most one
+    // dynamic dimension each (both or neither).
+    CachedRunner(InferenceRunner& runner, ResultCache& cache);
+
+    CachedRunner(const CachedRunner&) = delete;
+    CachedRunner& operator=(const CachedRunner&) = delete;
+
+    // Same contract as InferenceRunner::run(): the span stays valid until the next run().
+    Span<const float> run(Span<const float> input);
+
+    // Rows in the last run() and how many of them were sent to the model.
+    size_t last_rows() const { return last_rows_; }
+    size_t last_misses() const { return miss_rows_.size(); }
+
+private:
+    InferenceRunner& runner_;
+    ResultCache& cache_;
+    bool batched_;           // The model has a dynamic dimension to split along.
+    size_t input_row_size_;  // Elements per input row (the whole input when !batched_).
+    size_t output_row_size_; // Elements per output row.
+    size_t last_rows_ = 0;
+
+    // Reused by run().
+    std::vector<float> output_;
+    std::vector<float> miss_input_;
+    std::vector<size_t> miss_rows_;
+    std::vector<uint64_t> miss_hashes_;
+};
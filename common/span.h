@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstddef> // For size_t
+#include <type_traits> // For std::remove_const_t
+#include <vector>  // For constructing from std::vector
+
+// A non-owning view of a contiguous array, like C++20 std::span.
+//
+// The examples build as C++17, so this small stand-in is used to pass "a
+// pointer and a count" around without copying the data.
+template <typename T>
+class Span {
+public:
+    Span() = default;
+    Span(T* data, size_t size) : data_(data), size_(size) {}
+    // A Span<const float> can view a std::vector<float> (const or not).
+    Span(std::vector<std::remove_const_t<T>>& values) : data_(values.data()), size_(values.size()) {}
+    template <typename U = T, typename = std::enable_if_t<std::is_const<U>::value>>
+    Span(const std::vector<std::remove_const_t<T>>& values) : data_(values.data()), size_(values.size()) {}
+
+    T* data() const { return data_; }
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    T& operator[](size_t i) const { return data_[i]; }
+    T* begin() const { return data_; }
+    T* end() const { return data_ + size_; }
+
+private:
+    T* data_ = nullptr;
+    size_t size_ = 0;
+};
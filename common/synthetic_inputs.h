@@ -0,0 +1,203 @@
+#pragma once
+
+#include <cstdint>   // For int64_t dimensions
+#include <cstdlib>   // For std::strtoll, std::aligned_alloc
+#include <map>       // For named dimension overrides
+#include <memory>    // For std::unique_ptr
+#include <new>       // For std::bad_alloc
+#include <random>    // For random input values
+#include <stdexcept> // For std::invalid_argument
+#include <string>    // For std::string
+#include <vector>    // For shapes and buffers
+
+// ONNX Runtime C++ API header file
+#include <onnxruntime_cxx_api.h>
+
+#include "tensor_info.h"  // For tensor_element_size
+#include "typed_tensor.h" // For float_to_half_bits, float_to_bfloat16_bits
+
+// Values to use for dynamic (-1) dimensions when building synthetic inputs.
+// A dimension is resolved by its symbolic name (e.g. "batch_size") first. If
+// batch_value is set, the first dynamic dimension of each input that has no
+// named override is taken as the batch and gets batch_value. Every other
+// dynamic dimension gets default_value.
+struct DimOverrides {
+    std::map<std::string, int64_t> by_name;
+    int64_t default_value = 1;
+    int64_t batch_value = 0; // 0 = no batch dimension.
+
+    // Overrides for models whose first dynamic dimension is the batch.
+    static DimOverrides batch(int64_t batch_size) {
+        DimOverrides overrides;
+        overrides.batch_value = batch_size;
+        return overrides;
+    }
+
+    // Parses "name=value" (one named dimension) or "value" (all other dynamic dimensions).
+    void parse(const std::string& text) {
+        size_t equals = text.find('=');
+        std::string value_text = equals == std::string::npos ? text : text.substr(equals + 1);
+        char* end = nullptr;
+        long long value = std::strtoll(value_text.c_str(), &end, 10);
+        if (value_text.empty() || *end != '\0' || value <= 0) {
+            throw std::invalid_argument("invalid dimension override: " + text);
+        }
+        if (equals == std::string::npos) {
+            default_value = value;
+        } else {
+            by_name[text.substr(0, equals)] = value;
+        }
+    }
+};
+
+// Replaces every dynamic dimension of a model input with a concrete value.
+// TensorInfo is whatever TypeInfo::GetTensorTypeAndShapeInfo() returns.
+template <typename TensorInfo>
+std::vector<int64_t> resolve_shape(const TensorInfo& tensor_info, const DimOverrides& overrides) {
+    std::vector<int64_t> shape = tensor_info.GetShape();
+    std::vector<const char*> symbolic_names = tensor_info.GetSymbolicDimensions();
+    bool batch_assigned = overrides.batch_value <= 0;
+    for (size_t d = 0; d < shape.size(); ++d) {
+        if (shape[d] != -1) {
+            continue;
+        }
+        if (d < symbolic_names.size() && symbolic_names[d] != nullptr) {
+            auto it = overrides.by_name.find(symbolic_names[d]);
+            if (it != overrides.by_name.end()) {
+                shape[d] = it->second;
+                continue;
+            }
+        }
+        shape[d] = batch_assigned ? overrides.default_value : overrides.batch_value;
+        batch_assigned = true;
+    }
+    return shape;
+}
+
+// Correctly typed random tensors for every model input, ready to pass to session.Run.
+//
+// All input data lives in one 64-byte aligned arena that is sized up front, so
+// building the inputs is a single allocation no matter how many inputs the
+// model has. Floating point inputs get values in [-1, 1), integer inputs get
+// values in [0, 9] (small enough to be valid indices for most lookups) and
+// bool inputs get random true/false. String and complex inputs are not supported.
+class SyntheticInputs {
+public:
+    SyntheticInputs(Ort::Session& session, const DimOverrides& overrides) {
+        Ort::AllocatorWithDefaultOptions allocator;
+        auto memory_info = Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
+
+        // --- 1. Resolve every input's type and shape and lay them out in the arena ---
+        size_t input_count = session.GetInputCount();
+        std::vector<size_t> offsets;
+        std::vector<size_t> byte_counts;
+        size_t arena_size = 0;
+        for (size_t i = 0; i < input_count; ++i) {
+            name_ptrs_.push_back(session.GetInputNameAllocated(i, allocator));
+            names_.push_back(name_ptrs_.back().get());
+
+            Ort::TypeInfo type_info = session.GetInputTypeInfo(i);
+            auto tensor_info = type_info.GetTensorTypeAndShapeInfo();
+            ONNXTensorElementDataType type = tensor_info.GetElementType();
+            size_t element_size = tensor_element_size(type);
+            if (element_size == 0) {
+                throw std::runtime_error(std::string("synthetic inputs do not support the element type of input '") +
+                                         names_.back() + "'");
+            }
+            types_.push_back(type);
+            shapes_.push_back(resolve_shape(tensor_info, overrides));
+
+            size_t element_count = 1;
+            for (int64_t dim : shapes_.back()) {
+                element_count *= static_cast<size_t>(dim);
+            }
+            offsets.push_back(arena_size);
+            byte_counts.push_back(element_count * element_size);
+            arena_size += (byte_counts.back() + kAlignment - 1) / kAlignment * kAlignment;
+        }
+
+        // --- 2. One allocation for all input data ---
+        arena_.reset(static_cast<unsigned char*>(std::aligned_alloc(kAlignment, arena_size == 0 ? kAlignment : arena_size)));
+        if (!arena_) {
+            throw std::bad_alloc();
+        }
+        arena_size_ = arena_size;
+
+        // --- 3. Fill with random values of the right type and wrap as tensors ---
+        std::mt19937 rng(42);
+        for (size_t i = 0; i < input_count; ++i) {
+            void* data = arena_.get() + offsets[i];
+            fill_random(data, types_[i], byte_counts[i] / tensor_element_size(types_[i]), rng);
+            values_.push_back(Ort::Value::CreateTensor(
+                memory_info, data, byte_counts[i],
+                shapes_[i].data(), shapes_[i].size(), types_[i]));
+        }
+
+        for (size_t i = 0; i < session.GetOutputCount(); ++i) {
+            output_name_ptrs_.push_back(session.GetOutputNameAllocated(i, allocator));
+            output_names_.push_back(output_name_ptrs_.back().get());
+        }
+    }
+
+    // Runs the session once on the synthetic inputs.
+    std::vector<Ort::Value> run(Ort::Session& session) {
+        return session.Run(Ort::RunOptions{nullptr},
+                           names_.data(), values_.data(), values_.size(),
+                           output_names_.data(), output_names_.size());
+    }
+
+    const std::vector<const char*>& names() const { return names_; }
+    const std::vector<ONNXTensorElementDataType>& types() const { return types_; }
+    const std::vector<std::vector<int64_t>>& shapes() const { return shapes_; }
+    size_t arena_bytes() const { return arena_size_; }
+
+private:
+    static constexpr size_t kAlignment = 64;
+
+    struct FreeDeleter {
+        void operator()(unsigned char* p) const { std::free(p); }
+    };
+
+    template <typename T, typename Generate>
+    static void fill(void* data, size_t count, Generate generate) {
+        T* typed = static_cast<T*>(data);
+        for (size_t i = 0; i < count; ++i) {
+            typed[i] = generate();
+        }
+    }
+
+    static void fill_random(void* data, ONNXTensorElementDataType type, size_t count, std::mt19937& rng) {
+        std::uniform_real_distribution<float> real(-1.0f, 1.0f);
+        std::uniform_int_distribution<int> integer(0, 9);
+        switch (type) {
+            case ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT: fill<float>(data, count, [&] { return real(rng); }); break;
+            case ONNX_TENSOR_ELEMENT_DATA_TYPE_DOUBLE: fill<double>(data, count, [&] { return real(rng); }); break;
+            case ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT16:
+                fill<uint16_t>(data, count, [&] { return float_to_half_bits(real(rng)); });
+                break;
+            case ONNX_TENSOR_ELEMENT_DATA_TYPE_BFLOAT16:
+                fill<uint16_t>(data, count, [&] { return float_to_bfloat16_bits(real(rng)); });
+                break;
+            case ONNX_TENSOR_ELEMENT_DATA_TYPE_BOOL: fill<bool>(data, count, [&] { return (rng() & 1) != 0; }); break;
+            case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT8: fill<int8_t>(data, count, [&] { return integer(rng); }); break;
+            case ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT8: fill<uint8_t>(data, count, [&] { return integer(rng); }); break;
+            case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT16: fill<int16_t>(data, count, [&] { return integer(rng); }); break;
+            case ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT16: fill<uint16_t>(data, count, [&] { return integer(rng); }); break;
+            case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT32: fill<int32_t>(data, count, [&] { return integer(rng); }); break;
+            case ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT32: fill<uint32_t>(data, count, [&] { return integer(rng); }); break;
+            case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT64: fill<int64_t>(data, count, [&] { return integer(rng); }); break;
+            case ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT64: fill<uint64_t>(data, count, [&] { return integer(rng); }); break;
+            default: throw std::runtime_error("unsupported element type for synthetic inputs");
+        }
+    }
+
+    std::vector<Ort::AllocatedStringPtr> name_ptrs_;
+    std::vector<const char*> names_;
+    std::vector<ONNXTensorElementDataType> types_;
+    std::vector<std::vector<int64_t>> shapes_;
+    std::unique_ptr<unsigned char, FreeDeleter> arena_;
+    size_t arena_size_ = 0;
+    std::vector<Ort::Value> values_;
+    std::vector<Ort::AllocatedStringPtr> output_name_ptrs_;
+    std::vector<const char*> output_names_;
+};
@@ -0,0 +1,64 @@
+#include "tensor_info.h"
+
+std::string get_tensor_data_type_string(ONNXTensorElementDataType type) {
+    switch (type) {
+        case ONNX_TENSOR_ELEMENT_DATA_TYPE_UNDEFINED: return "undefined";
+        case ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT: return "float";
+        case ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT8: return "uint8";
+        case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT8: return "int8";
+        case ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT16: return "uint16";
+        case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT16: return "int16";
+        case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT32: return "int32";
+        case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT64: return "int64";
+        case ONNX_TENSOR_ELEMENT_DATA_TYPE_STRING: return "string";
+        case ONNX_TENSOR_ELEMENT_DATA_TYPE_BOOL: return "bool";
+        case ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT16: return "float16";
+        case ONNX_TENSOR_ELEMENT_DATA_TYPE_DOUBLE: return "double";
+        case ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT32: return "uint32";
+        case ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT64: return "uint64";
+        case ONNX_TENSOR_ELEMENT_DATA_TYPE_COMPLEX64: return "complex64";
+        case ONNX_TENSOR_ELEMENT_DATA_TYPE_COMPLEX128: return "complex128";
+        case ONNX_TENSOR_ELEMENT_DATA_TYPE_BFLOAT16: return "bfloat16";
+        default: return "unknown";
+    }
+}
+
+bool is_shape_static(const std::vector<int64_t>& shape) {
+    for (int64_t dim : shape) {
+        if (dim == -1) {
+            return false;
+        }
+    }
+    return true;
+}
+
+std::string shape_to_string(const std::vector<int64_t>& shape) {
+    std::string text = "[";
+    for (size_t i = 0; i < shape.size(); ++i) {
+        // -1 indicates a dynamic dimension (e.g., batch size)
+        text += shape[i] == -1 ? "dynamic" : std::to_string(shape[i]);
+        if (i + 1 < shape.size()) {
+            text += ", ";
+        }
+    }
+    return text + "]";
+}
+
+size_t tensor_element_size(ONNXTensorElementDataType type) {
+    switch (type) {
+        case ONNX_TENSOR_ELEMENT_DATA_TYPE_BOOL:
+        case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT8:
+        case ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT8: return 1;
+        case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT16:
+        case ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT16:
+        case ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT16:
+        case ONNX_TENSOR_ELEMENT_DATA_TYPE_BFLOAT16: return 2;
+        case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT32:
+        case ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT32:
+        case ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT: return 4;
+        case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT64:
+        case ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT64:
+        case ONNX_TENSOR_ELEMENT_DATA_TYPE_DOUBLE: return 8;
+        default: return 0;
+    }
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <cstddef> // For size_t
+#include <cstdint> // For int64_t dimensions
+#include <string>  // For std::string
+#include <vector>  // For shapes
+
+// ONNX Runtime C++ API header file
+#include <onnxruntime_cxx_api.h>
+
+// Helpers for describing tensor types and shapes, shared by the examples.
+
+// Converts ONNXTensorElementDataType to a readable string, e.g. "float".
+std::string get_tensor_data_type_string(ONNXTensorElementDataType type);
+
+// Checks if a shape is static (contains no -1). This replaces the
+// HasStaticShape() method for broader compatibility.
+bool is_shape_static(const std::vector<int64_t>& shape);
+
+// Formats a shape as "[dynamic, 1]", writing "dynamic" for -1 dimensions.
+std::string shape_to_string(const std::vector<int64_t>& shape);
+
+// Size in bytes of one element of a tensor type, or 0 for types that cannot be
+// stored as plain bytes (string) or are not supported here.
+size_t tensor_element_size(ONNXTensorElementDataType type);
@@ -0,0 +1,138 @@
+#include "typed_tensor.h"
+
+#include <cmath>     // For std::nearbyint, std::isnan
+#include <limits>    // For std::numeric_limits
+#include <stdexcept> // For std::invalid_argument
+#include <string>    // For the error message
+
+#include "tensor_info.h" // For get_tensor_data_type_string
+
+namespace {
+
+// Rounds to nearest and clamps to T's range; NaN becomes 0.
+template <typename T>
+T saturate_cast(float value) {
+    if (std::isnan(value)) {
+        return T(0);
+    }
+    double rounded = std::nearbyint(static_cast<double>(value));
+    if (rounded <= static_cast<double>(std::numeric_limits<T>::lowest())) {
+        return std::numeric_limits<T>::lowest();
+    }
+    if (rounded >= static_cast<double>(std::numeric_limits<T>::max())) {
+        return std::numeric_limits<T>::max();
+    }
+    return static_cast<T>(rounded);
+}
+
+template <typename T>
+void integers_from_float(const float* input, size_t count, void* output) {
+    T* typed = static_cast<T*>(output);
+    for (size_t i = 0; i < count; ++i) {
+        typed[i] = saturate_cast<T>(input[i]);
+    }
+}
+
+template <typename T>
+void values_to_float(const void* input, size_t count, float* output) {
+    const T* typed = static_cast<const T*>(input);
+    for (size_t i = 0; i < count; ++i) {
+        output[i] = static_cast<float>(typed[i]);
+    }
+}
+
+std::invalid_argument unsupported(ONNXTensorElementDataType type) {
+    return std::invalid_argument("no float conversion for element type " + get_tensor_data_type_string(type));
+}
+
+} // namespace
+
+bool is_convertible_from_float(ONNXTensorElementDataType type) {
+    switch (type) {
+        case ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT:
+        case ONNX_TENSOR_ELEMENT_DATA_TYPE_DOUBLE:
+        case ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT16:
+        case ONNX_TENSOR_ELEMENT_DATA_TYPE_BFLOAT16:
+        case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT8:
+        case ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT8:
+        case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT16:
+        case ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT16:
+        case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT32:
+        case ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT32:
+        case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT64:
+        case ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT64:
+            return true;
+        default:
+            return false;
+    }
+}
+
+void convert_from_float(const float* input, size_t count, ONNXTensorElementDataType type, void* output) {
+    switch (type) {
+        case ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT:
+            std::memcpy(output, input, count * sizeof(float));
+            break;
+        case ONNX_TENSOR_ELEMENT_DATA_TYPE_DOUBLE: {
+            double* typed = static_cast<double*>(output);
+            for (size_t i = 0; i < count; ++i) {
+                typed[i] = input[i];
+            }
+            break;
+        }
+        case ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT16: {
+            uint16_t* typed = static_cast<uint16_t*>(output);
+            for (size_t i = 0; i < count; ++i) {
+                typed[i] = float_to_half_bits(input[i]);
+            }
+            break;
+        }
+        case ONNX_TENSOR_ELEMENT_DATA_TYPE_BFLOAT16: {
+            uint16_t* typed = static_cast<uint16_t*>(output);
+            for (size_t i = 0; i < count; ++i) {
+                typed[i] = float_to_bfloat16_bits(input[i]);
+            }
+            break;
+        }
+        case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT8: integers_from_float<int8_t>(input, count, output); break;
+        case ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT8: integers_from_float<uint8_t>(input, count, output); break;
+        case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT16: integers_from_float<int16_t>(input, count, output); break;
+        case ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT16: integers_from_float<uint16_t>(input, count, output); break;
+        case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT32: integers_from_float<int32_t>(input, count, output); break;
+        case ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT32: integers_from_float<uint32_t>(input, count, output); break;
+        case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT64: integers_from_float<int64_t>(input, count, output); break;
+        case ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT64: integers_from_float<uint64_t>(input, count, output); break;
+        default: throw unsupported(type);
+    }
+}
+
+void convert_to_float(const void* input, size_t count, ONNXTensorElementDataType type, float* output) {
+    switch (type) {
+        case ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT:
+            std::memcpy(output, input, count * sizeof(float));
+            break;
+        case ONNX_TENSOR_ELEMENT_DATA_TYPE_DOUBLE: values_to_float<double>(input, count, output); break;
+        case ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT16: {
+            const uint16_t* typed = static_cast<const uint16_t*>(input);
+            for (size_t i = 0; i < count; ++i) {
+                output[i] = half_bits_to_float(typed[i]);
+            }
+            break;
+        }
+        case ONNX_TENSOR_ELEMENT_DATA_TYPE_BFLOAT16: {
+            const uint16_t* typed = static_cast<const uint16_t*>(input);
+            for (size_t i = 0; i < count; ++i) {
+                output[i] = bfloat16_bits_to_float(typed[i]);
+            }
+            break;
+        }
+        case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT8: values_to_float<int8_t>(input, count, output); break;
+        case ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT8: values_to_float<uint8_t>(input, count, output); break;
+        case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT16: values_to_float<int16_t>(input, count, output); break;
+        case ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT16: values_to_float<uint16_t>(input, count, output); break;
+        case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT32: values_to_float<int32_t>(input, count, output); break;
+        case ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT32: values_to_float<uint32_t>(input, count, output); break;
+        case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT64: values_to_float<int64_t>(input, count, output); break;
+        case ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT64: values_to_float<uint64_t>(input, count, output); break;
+        default: throw unsupported(type);
+    }
+}
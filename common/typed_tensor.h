@@ -0,0 +1,107 @@
+#pragma once
+
+#include <cstddef> // For size_t
+#include <cstdint> // For uint16_t, uint32_t
+#include <cstring> // For std::memcpy
+
+// ONNX Runtime C++ API header file
+#include <onnxruntime_cxx_api.h>
+
+// Conversions between float and the other numeric tensor element types, so
+// code written against float data can feed and read FP16, BF16 and integer
+// (e.g. quantized) models.
+
+// Converts a float to IEEE 754 half precision bits (round to nearest even).
+inline uint16_t float_to_half_bits(float value) {
+    uint32_t f;
+    std::memcpy(&f, &value, sizeof(f));
+    uint32_t sign = (f >> 16) & 0x8000u;
+    uint32_t float_exponent = (f >> 23) & 0xffu;
+    uint32_t mantissa = f & 0x7fffffu;
+    if (float_exponent == 0xffu) {
+        return static_cast<uint16_t>(sign | 0x7c00u | (mantissa != 0 ? 0x200u : 0u)); // Inf or NaN
+    }
+    int32_t exponent = static_cast<int32_t>(float_exponent) - 127 + 15;
+    if (exponent >= 0x1f) {
+        return static_cast<uint16_t>(sign | 0x7c00u); // Too large: infinity
+    }
+    if (exponent <= 0) {
+        if (exponent < -10) {
+            return static_cast<uint16_t>(sign); // Too small: signed zero
+        }
+        // Subnormal half: shift the mantissa (with its implicit leading 1) into place.
+        mantissa |= 0x800000u;
+        uint32_t shift = static_cast<uint32_t>(14 - exponent);
+        uint32_t half = mantissa >> shift;
+        uint32_t remainder = mantissa & ((1u << shift) - 1u);
+        uint32_t halfway = 1u << (shift - 1);
+        if (remainder > halfway || (remainder == halfway && (half & 1u))) {
+            ++half;
+        }
+        return static_cast<uint16_t>(sign | half);
+    }
+    uint32_t half = sign | (static_cast<uint32_t>(exponent) << 10) | (mantissa >> 13);
+    uint32_t remainder = mantissa & 0x1fffu;
+    if (remainder > 0x1000u || (remainder == 0x1000u && (half & 1u))) {
+        ++half; // A carry into the exponent is still the correctly rounded value.
+    }
+    return static_cast<uint16_t>(half);
+}
+
+// Converts IEEE 754 half precision bits to a float.
+inline float half_bits_to_float(uint16_t half) {
+    uint32_t sign = (static_cast<uint32_t>(half) & 0x8000u) << 16;
+    uint32_t exponent = (half >> 10) & 0x1fu;
+    uint32_t mantissa = half & 0x3ffu;
+    uint32_t f;
+    if (exponent == 0x1fu) {
+        f = sign | 0x7f800000u | (mantissa << 13); // Inf or NaN
+    } else if (exponent != 0) {
+        f = sign | ((exponent - 15 + 127) << 23) | (mantissa << 13);
+    } else if (mantissa == 0) {
+        f = sign; // Signed zero
+    } else {
+        // Subnormal half: normalize it for the float representation.
+        exponent = 127 - 15 + 1;
+        while ((mantissa & 0x400u) == 0) {
+            mantissa <<= 1;
+            --exponent;
+        }
+        f = sign | (exponent << 23) | ((mantissa & 0x3ffu) << 13);
+    }
+    float value;
+    std::memcpy(&value, &f, sizeof(value));
+    return value;
+}
+
+// Converts a float to bfloat16 bits, the upper half of a float32 (round to nearest even).
+inline uint16_t float_to_bfloat16_bits(float value) {
+    uint32_t f;
+    std::memcpy(&f, &value, sizeof(f));
+    if ((f & 0x7fffffffu) > 0x7f800000u) {
+        return static_cast<uint16_t>((f >> 16) | 0x40u); // Keep NaN a (quiet) NaN
+    }
+    f += 0x7fffu + ((f >> 16) & 1u);
+    return static_cast<uint16_t>(f >> 16);
+}
+
+// Converts bfloat16 bits to a float.
+inline float bfloat16_bits_to_float(uint16_t bits) {
+    uint32_t f = static_cast<uint32_t>(bits) << 16;
+    float value;
+    std::memcpy(&value, &f, sizeof(value));
+    return value;
+}
+
+// True if convert_from_float/convert_to_float handle the element type:
+// float, double, float16, bfloat16 and the 8/16/32/64-bit integer types.
+bool is_convertible_from_float(ONNXTensorElementDataType type);
+
+// Writes count floats to `output` as elements of `type`. Integer types are
+// rounded to nearest and saturated to the type's range (NaN becomes 0).
+// Throws std::invalid_argument for unsupported types.
+void convert_from_float(const float* input, size_t count, ONNXTensorElementDataType type, void* output);
+
+// Reads count elements of `type` from `input` as floats.
+// Throws std::invalid_argument for unsupported types.
+void convert_to_float(const void* input, size_t count, ONNXTensorElementDataType type, float* output);
@@ -82,3 +82,124 @@ except Exception as e:
     print(f"Error exporting model to ONNX: {e}")
 
 print(f"You can now use '{onnx_filename}' with ONNX Runtime or other ONNX-compatible tools.")
+
+# 7. Export reduced-precision variants (optional)
+# These need the 'onnx', 'onnxruntime' and 'onnxconverter-common' packages.
+#   linear_int8.onnx: dynamically quantized, INT8 weights with float input/output
+#   linear_fp16.onnx: every tensor, including the input and output, in float16
+# Compare them against the FP32 model with the linear_precision example.
+try:
+    import os
+    import tempfile
+    import onnx
+    from onnx import helper, numpy_helper
+    from onnxruntime.quantization import quantize_dynamic, QuantType
+    from onnxconverter_common import float16
+
+    float_model = onnx.load(onnx_filename)
+
+    # Dynamic quantization handles MatMul but not Gemm, so rewrite the Gemm
+    # that nn.Linear exports as MatMul + Add first.
+    graph = float_model.graph
+    initializers = {init.name: init for init in graph.initializer}
+    nodes = []
+    for node in graph.node:
+        if node.op_type != "Gemm":
+            nodes.append(node)
+            continue
+        attributes = {attr.name: helper.get_attribute_value(attr) for attr in node.attribute}
+        weight_name = node.input[1]
+        if attributes.get("transB", 0):
+            weight = numpy_helper.to_array(initializers[weight_name]).T.copy()
+            initializers[weight_name].CopyFrom(numpy_helper.from_array(weight, weight_name))
+        matmul_output = node.output[0] + "_matmul"
+        nodes.append(helper.make_node("MatMul", [node.input[0], weight_name], [matmul_output]))
+        nodes.append(helper.make_node("Add", [matmul_output, node.input[2]], [node.output[0]]))
+    del graph.node[:]
+    graph.node.extend(nodes)
+    # The MatMul model is only an input to the quantizer, so it goes to a
+    # temporary directory instead of next to the other models.
+    int8_filename = "linear_int8.onnx"
+    with tempfile.TemporaryDirectory() as temp_dir:
+        matmul_filename = os.path.join(temp_dir, "linear_matmul.onnx")
+        onnx.save(float_model, matmul_filename)
+        quantize_dynamic(matmul_filename, int8_filename,
+                         op_types_to_quantize=["MatMul"],
+                         weight_type=QuantType.QInt8)
+    print(f"Quantized model exported to {int8_filename}")
+
+    fp16_filename = "linear_fp16.onnx"
+    fp16_model = float16.convert_float_to_float16(onnx.load(onnx_filename), keep_io_types=False)
+    onnx.save(fp16_model, fp16_filename)
+    print(f"FP16 model exported to {fp16_filename}")
+
+except ImportError as e:
+    print(f"Skipping the reduced-precision variants ({e}).")
+except Exception as e:
+    print(f"Error exporting reduced-precision variants: {e}")
+
+# 8. Export a large variant for the memory-mapped loading example (optional)
+# Same y = 2x, but through 2048-wide identity layers holding ~64 MB of
+# weights: x @ ones[1, H] @ I @ I @ I @ I @ (2/H)[H, 1]. Written twice:
+#   linear_large.onnx + linear_large.onnx.data: weights in an external data file
+#   linear_large.ort: ORT format, weights inside the model file
+# Compare path-based and mmap loading with the linear_mmap example.
+try:
+    import numpy as np
+    import onnx
+    import onnxruntime as ort
+    from onnx import helper, numpy_helper, TensorProto
+
+    hidden = 2048
+    identity_layers = 4
+    initializers = [numpy_helper.from_array(np.ones((1, hidden), dtype=np.float32), "w_in")]
+    nodes = [helper.make_node("MatMul", ["input", "w_in"], ["h0"])]
+    for i in range(identity_layers):
+        initializers.append(numpy_helper.from_array(np.eye(hidden, dtype=np.float32), f"w{i + 1}"))
+        nodes.append(helper.make_node("MatMul", [f"h{i}", f"w{i + 1}"], [f"h{i + 1}"]))
+    initializers.append(numpy_helper.from_array(np.full((hidden, 1), 2.0 / hidden, dtype=np.float32), "w_out"))
+    nodes.append(helper.make_node("MatMul", [f"h{identity_layers}", "w_out"], ["output"]))
+    graph = helper.make_graph(
+        nodes, "linear_large",
+        [helper.make_tensor_value_info("input", TensorProto.FLOAT, ["batch_size", 1])],
+        [helper.make_tensor_value_info("output", TensorProto.FLOAT, ["batch_size", 1])],
+        initializers)
+    large_model = helper.make_model(graph, opset_imports=[helper.make_opsetid("", 11)])
+
+    large_filename = "linear_large.onnx"
+    onnx.save(large_model, large_filename, save_as_external_data=True,
+              all_tensors_to_one_file=True, location=large_filename + ".data", size_threshold=1024)
+    print(f"Large model exported to {large_filename} (+ {large_filename}.data)")
+
+    # Basic optimizations only, so the .ort file runs on any execution provider.
+    ort_filename = "linear_large.ort"
+    options = ort.SessionOptions()
+    options.graph_optimization_level = ort.GraphOptimizationLevel.ORT_ENABLE_BASIC
+    options.optimized_model_filepath = ort_filename
+    options.add_session_config_entry("session.save_model_format", "ORT")
+    ort.InferenceSession(large_filename, options, providers=["CPUExecutionProvider"])
+    print(f"ORT-format model exported to {ort_filename}")
+
+except ImportError as e:
+    print(f"Skipping the large model ({e}).")
+except Exception as e:
+    print(f"Error exporting the large model: {e}")
+
+# 9. Export a y = 3x variant for the hot-reload example
+# Same graph as linear.onnx with the weight and bias scaled by 1.5, so its
+# outputs differ from linear.onnx's. linear_reload swaps between the two and
+# checks that requests after each swap see the new model's outputs.
+x3_filename = "linear_x3.onnx"
+try:
+    with torch.no_grad():
+        model.linear.weight.mul_(1.5)
+        model.linear.bias.mul_(1.5)
+    torch.onnx.export(model, dummy_input, x3_filename,
+                      export_params=True, opset_version=11, do_constant_folding=True,
+                      input_names=['input'], output_names=['output'],
+                      dynamic_axes={'input' : {0 : 'batch_size'},
+                                    'output' : {0 : 'batch_size'}})
+    print(f"y = 3x model exported to {x3_filename}")
+
+except Exception as e:
+    print(f"Error exporting the y = 3x model: {e}")